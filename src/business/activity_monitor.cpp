@@ -0,0 +1,62 @@
+// activity_monitor.cpp
+#include "activity_monitor.h"
+
+#include <cmath>
+
+void ActivityMonitor::init(uint32_t fs_hz) {
+    fs = fs_hz ? fs_hz : 1;
+    a_g = 1.0f - std::exp(-1.0f / (GRAVITY_TAU_S * (float)fs));
+    a_act = 1.0f - std::exp(-1.0f / (LEVEL_TAU_S * (float)fs));
+    hold = (uint32_t)(HOLD_S * (float)fs);
+    reset();
+    clearStats();
+}
+
+void ActivityMonitor::reset() {
+    primed = false;
+    gravity = 0.0f;
+    act = 0.0f;
+    current = HrMode::Full;
+    calm = 0;
+}
+
+void ActivityMonitor::clearStats() {
+    for (auto &t : time_in) t = 0;
+}
+
+HrMode ActivityMonitor::update(const float* mag, std::size_t n) {
+    if (!mag || fs == 0) {
+        return current; // no-op if invalid
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const float m = mag[i];
+        if (!primed) {
+            gravity = m;
+            primed = true;
+        }
+        gravity += a_g * (m - gravity);
+        act += a_act * (std::fabs(m - gravity) - act);
+
+        // Escalate at once
+        if (act >= SUSPEND_ON) {
+            current = HrMode::Suspended;
+            calm = 0;
+        } else if (act >= REDUCED_ON && current == HrMode::Full) {
+            current = HrMode::Reduced;
+            calm = 0;
+        }
+
+        // Step down after HOLD_S below the current mode's OFF threshold
+        const float off = current == HrMode::Suspended ? SUSPEND_OFF : REDUCED_OFF;
+        if (current != HrMode::Full && act < off) {
+            if (++calm >= hold) {
+                current = act < REDUCED_OFF ? HrMode::Full : HrMode::Reduced;
+                calm = 0;
+            }
+        } else {
+            calm = 0;
+        }
+        ++time_in[(std::size_t)current];
+    }
+    return current;
+}
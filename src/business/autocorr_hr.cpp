@@ -0,0 +1,93 @@
+// autocorr_hr.cpp
+#include "autocorr_hr.h"
+
+#include <cmath>
+
+bool AutocorrHr::init(uint32_t fs_hz) {
+    const std::size_t lo = (std::size_t)std::floor(60.0f * (float)fs_hz / BPM_MAX);
+    const std::size_t hi = (std::size_t)std::ceil(60.0f * (float)fs_hz / BPM_MIN);
+    if (lo < 2 || hi + 1 > LAG_MAX + 1) {
+        return false;
+    }
+    fs = fs_hz;
+    lag_lo = lo;
+    lag_hi = hi;
+    lambda = std::exp(-1.0f / (TAU_S * (float)fs));
+    warmup = hi + 1 + (std::size_t)(TAU_S * (float)fs);
+    reset();
+    return true;
+}
+
+void AutocorrHr::reset() {
+    r0 = 0.0f;
+    for (auto &v : r) v = 0.0f;
+    for (auto &v : hist) v = 0.0f;
+    pos = 0;
+    seen = 0;
+}
+
+void AutocorrHr::process(const float* x, std::size_t n) {
+    if (!x || fs == 0) {
+        return; // no-op if invalid
+    }
+    const std::size_t first = lag_lo - 1, last = lag_hi + 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        const float v = x[i];
+        pos = (pos + 1) & (RING - 1);
+        hist[pos] = v;
+        if (seen < warmup) ++seen;
+
+        // R[l] = lambda * R[l] + x(n) * x(n - l)
+        r0 = lambda * r0 + v * v;
+        for (std::size_t l = first; l <= last; ++l) {
+            r[l] = lambda * r[l] + v * hist[(pos - l) & (RING - 1)];
+        }
+    }
+}
+
+bool AutocorrHr::estimate(Estimate& out) const {
+    if (fs == 0 || seen < warmup) {
+        return false;
+    }
+    if (!(r0 > 0.0f)) {
+        return false;
+    }
+
+    // Local maxima refined by parabolic interpolation: on a coarse lag grid
+    // the sampled peaks of a sharp pulse depend on where the period falls
+    // between two lags, so peaks are compared at their interpolated height
+    float best = 0.0f;
+    for (std::size_t l = lag_lo; l <= lag_hi; ++l) {
+        float d, h;
+        if (refine(l, d, h) && h > best) best = h;
+    }
+    if (!(best > 0.0f)) {
+        return false; // nothing periodic in range
+    }
+
+    // Shortest peak close to the best one: rejects 2x, 3x periods
+    for (std::size_t l = lag_lo; l <= lag_hi; ++l) {
+        float delta, peak;
+        if (!refine(l, delta, peak) || peak < PEAK_FRACTION * best) {
+            continue;
+        }
+        out.bpm = 60.0f * (float)fs / ((float)l + delta);
+        const float score = peak / r0;
+        out.score = score > 1.0f ? 1.0f : (score < 0.0f ? 0.0f : score);
+        return true;
+    }
+    return false;
+}
+
+bool AutocorrHr::refine(std::size_t l, float& delta, float& peak) const {
+    const float a = r[l - 1], b = r[l], c = r[l + 1];
+    if (b < a || b < c) {
+        return false; // not a local maximum
+    }
+    const float den = a - 2.0f * b + c;
+    delta = den < 0.0f ? 0.5f * (a - c) / den : 0.0f;
+    if (delta > 0.5f) delta = 0.5f;
+    if (delta < -0.5f) delta = -0.5f;
+    peak = b - 0.25f * (a - c) * delta;
+    return true;
+}
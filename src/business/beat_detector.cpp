@@ -0,0 +1,165 @@
+// beat_detector.cpp
+#include "beat_detector.h"
+
+#include <cmath>
+
+void BeatDetector::init(uint32_t fs_hz) {
+    fs = fs_hz ? fs_hz : 1;
+    env_decay = std::exp(-1.0f / (ENVELOPE_TAU_S * (float)fs));
+    refractory_min = (REFRACTORY_MIN_MS * fs + 999) / 1000;
+    rr_max = RR_MAX_MS * fs / 1000;
+    timeout = BEAT_TIMEOUT_MS * fs / 1000;
+    reset();
+}
+
+void BeatDetector::reset() {
+    n = 0;
+    x1 = x2 = 0.0f;
+    env = 0.0f;
+    rise_slope = 0.0f;
+    slope_avg = 0.0f;
+    trough = 0.0f;
+    have_last = false;
+    last_n = 0;
+    last_frac = 0.0f;
+    last_rr = 0;
+    beat_count = 0;
+    run = 0;
+    rr_head = 0;
+    rr_count = 0;
+}
+
+std::size_t BeatDetector::process(const float* x, std::size_t len) {
+    if (!x) {
+        return 0; // no-op if invalid
+    }
+    const uint32_t before = beat_count;
+    for (std::size_t i = 0; i < len; ++i) {
+        const float v = x[i];
+        if (n == 0) {
+            x1 = x2 = v;
+            trough = v;
+        }
+        const float d = v - x1;
+        const float d1 = x1 - x2;
+
+        // Upstroke slope, restarted at every local minimum
+        if (d > 0.0f) {
+            if (d1 <= 0.0f) rise_slope = 0.0f;
+            if (d > rise_slope) rise_slope = d;
+        }
+
+        // x1 is a local maximum: candidate beat at sample n - 1
+        if (d1 > 0.0f && d <= 0.0f && n >= 2) {
+            const float den = x2 - 2.0f * x1 + v;
+            float frac = den < 0.0f ? 0.5f * (x2 - v) / den : 0.0f;
+            if (frac > 0.5f) frac = 0.5f;
+            if (frac < -0.5f) frac = -0.5f;
+            const float height = x1 - 0.25f * (x2 - v) * frac;
+
+            const uint32_t since = n - 1 - last_n;
+            const uint32_t refractory = (last_rr / 2 > refractory_min) ? last_rr / 2 : refractory_min;
+            if (height >= THRESHOLD * env && rise_slope >= SLOPE_FRACTION * slope_avg &&
+                (!have_last || since >= refractory)) {
+                onPeak(frac, rise_slope, height);
+            }
+        }
+        if (v < trough) trough = v;
+
+        // Peak envelope: jumps to new maxima, decays in between
+        env *= env_decay;
+        if (v > env) env = v;
+
+        x2 = x1;
+        x1 = v;
+        ++n;
+
+        if (have_last && n - last_n > timeout) {
+            run = 0;
+        }
+    }
+    return beat_count - before;
+}
+
+void BeatDetector::onPeak(float frac, float slope, float height) {
+    const uint32_t idx = n - 1;
+    slope_avg = (beat_count == 0) ? slope : slope_avg + 0.125f * (slope - slope_avg);
+    ++beat_count;
+
+    if (have_last) {
+        const float rr_samples = (float)(idx - last_n) + (frac - last_frac);
+        const uint32_t whole = idx - last_n;
+        if (whole <= rr_max) {
+            const float ms = rr_samples * 1000.0f / (float)fs;
+            rr_ring[rr_head] = (uint16_t)(ms + 0.5f);
+            amp_ring[rr_head] = height - trough;
+            rr_head = (rr_head + 1) % RR_RING;
+            if (rr_count < RR_RING) ++rr_count;
+            ++rr_total;
+            if (run < RR_RING) ++run;
+            last_rr = whole;
+        } else {
+            // Gap (missed beats, lost contact): start a new run
+            run = 0;
+            last_rr = 0;
+        }
+    }
+    have_last = true;
+    trough = height;
+    last_n = idx;
+    last_frac = frac;
+}
+
+uint16_t BeatDetector::rr(std::size_t i) const {
+    if (i >= rr_count) return 0;
+    return rr_ring[(rr_head + RR_RING - 1 - i) % RR_RING];
+}
+
+float BeatDetector::amplitude(std::size_t i) const {
+    if (i >= rr_count) return 0.0f;
+    return amp_ring[(rr_head + RR_RING - 1 - i) % RR_RING];
+}
+
+bool BeatDetector::bpm(float& out) const {
+    if (run < MIN_VALID_RR) {
+        return false;
+    }
+    // Median of the newest intervals of the current run (insertion sort, k <= 5)
+    const std::size_t k = run < MEDIAN_LEN ? run : MEDIAN_LEN;
+    uint16_t v[MEDIAN_LEN];
+    for (std::size_t i = 0; i < k; ++i) {
+        uint16_t r = rr(i);
+        std::size_t j = i;
+        while (j > 0 && v[j - 1] > r) {
+            v[j] = v[j - 1];
+            --j;
+        }
+        v[j] = r;
+    }
+    const float med = (k % 2) ? (float)v[k / 2] : 0.5f * ((float)v[k / 2 - 1] + (float)v[k / 2]);
+    if (med <= 0.0f) {
+        return false;
+    }
+    out = 60000.0f / med;
+    return true;
+}
+
+float BeatDetector::confidence() const {
+    if (run < MIN_VALID_RR) {
+        return 0.0f;
+    }
+    const std::size_t k = run < MEDIAN_LEN ? run : MEDIAN_LEN;
+    uint16_t lo = rr(0), hi = rr(0);
+    for (std::size_t i = 1; i < k; ++i) {
+        const uint16_t r = rr(i);
+        if (r < lo) lo = r;
+        if (r > hi) hi = r;
+    }
+    float med;
+    if (!bpm(med)) {
+        return 0.0f;
+    }
+    med = 60000.0f / med;
+    const float c = 1.0f - (float)(hi - lo) / med;
+    return c < 0.0f ? 0.0f : c;
+}
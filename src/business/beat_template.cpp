@@ -0,0 +1,187 @@
+// beat_template.cpp
+#include "beat_template.h"
+
+#include <cmath>
+
+namespace {
+
+// Zero mean, unit RMS in place; false for a flat segment
+bool normalize(float* v, std::size_t n) {
+    float mean = 0.0f;
+    for (std::size_t i = 0; i < n; ++i) mean += v[i];
+    mean /= (float)n;
+    float sq = 0.0f;
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] -= mean;
+        sq += v[i] * v[i];
+    }
+    if (!(sq > 1e-12f)) {
+        return false;
+    }
+    const float scale = 1.0f / std::sqrt(sq / (float)n);
+    for (std::size_t i = 0; i < n; ++i) v[i] *= scale;
+    return true;
+}
+
+} // namespace
+
+void BeatTemplate::init(uint32_t fs_hz) {
+    fs = fs_hz ? fs_hz : 1;
+    reset();
+}
+
+void BeatTemplate::reset() {
+    ring.clear();
+    have_peak = false;
+    peak_idx = 0;
+    peak_frac = 0.0f;
+    for (auto &t : tmpl) t = 0.0f;
+    blended = 0;
+    rejects = 0;
+    rr_avg = 0.0f;
+    have_score = false;
+    last = Beat{};
+}
+
+void BeatTemplate::process(const float* x, std::size_t n) {
+    if (!x) {
+        return; // no-op if invalid
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        ring.push(x[i]);
+    }
+}
+
+bool BeatTemplate::resample(uint32_t from, float frac, float len, float* out) const {
+    // The whole segment, plus the sample after its last point, must be held
+    const uint32_t end = ring.count();
+    if (end - from > RING || (uint32_t)(frac + len) + 1 > end - from) {
+        return false;
+    }
+    const float step = len / (float)(POINTS - 1);
+    for (std::size_t k = 0; k < POINTS; ++k) {
+        const float p = frac + step * (float)k;
+        const uint32_t i = (uint32_t)p;
+        const float f = p - (float)i;
+        const float a = ring.at(from + i);
+        out[k] = (f > 0.0f && from + i + 1 != end) ? a + f * (ring.at(from + i + 1) - a) : a;
+    }
+    return true;
+}
+
+void BeatTemplate::start(const float* beat, float len) {
+    for (std::size_t k = 0; k < POINTS; ++k) tmpl[k] = beat[k];
+    blended = 1;
+    rejects = 0;
+    rr_avg = len;
+}
+
+bool BeatTemplate::onBeat(float peak_age, bool adjacent) {
+    const uint32_t end = ring.count();
+    if (end == 0 || !(peak_age >= 0.0f) || peak_age >= (float)end) {
+        return false;
+    }
+    // Split the peak position into a ring index and a 0..1 fraction
+    const float back = std::ceil(peak_age);
+    const uint32_t idx = end - 1 - (uint32_t)back;
+    const float frac = back - peak_age;
+
+    const bool chained = have_peak && adjacent;
+    const uint32_t from = peak_idx;
+    const float from_frac = peak_frac;
+    have_peak = true;
+    peak_idx = idx;
+    peak_frac = frac;
+    if (!chained) {
+        return false;
+    }
+
+    const float len = (float)(idx - from) + (frac - from_frac);
+    float beat[POINTS];
+    if (len < 2.0f || !resample(from, from_frac, len, beat) || !normalize(beat, POINTS)) {
+        return false;
+    }
+    if (blended == 0) {
+        start(beat, len);
+        return false;
+    }
+
+    float dot = 0.0f, tt = 0.0f;
+    for (std::size_t k = 0; k < POINTS; ++k) {
+        dot += beat[k] * tmpl[k];
+        tt += tmpl[k] * tmpl[k];
+    }
+    // The beat has unit RMS: sum(beat^2) = POINTS
+    const float corr = tt > 0.0f ? dot / std::sqrt(tt * (float)POINTS) : 0.0f;
+    last.correlation = corr;
+    last.good = corr >= GOOD_CORR;
+    have_score = true;
+
+    if (blended < LEARN_BEATS) {
+        // Running mean while the template forms
+        const float w = 1.0f / (float)(blended + 1);
+        for (std::size_t k = 0; k < POINTS; ++k) tmpl[k] += w * (beat[k] - tmpl[k]);
+        rr_avg += w * (len - rr_avg);
+        ++blended;
+    } else if (corr >= BLEND_CORR) {
+        for (std::size_t k = 0; k < POINTS; ++k) tmpl[k] += ALPHA * (beat[k] - tmpl[k]);
+        rr_avg += ALPHA * (len - rr_avg);
+        ++blended;
+        rejects = 0;
+    } else if (++rejects >= RELEARN_AFTER) {
+        start(beat, len);
+    }
+    return true;
+}
+
+bool BeatTemplate::lastBeat(Beat& out) const {
+    if (!have_score) {
+        return false;
+    }
+    out = last;
+    return true;
+}
+
+bool BeatTemplate::features(Features& out) const {
+    if (blended < LEARN_BEATS) {
+        return false;
+    }
+    const float ms_per_point = rr_avg * 1000.0f / (float)fs / (float)(POINTS - 1);
+
+    // Systolic peak: interpolation at low rates can leave the top a point
+    // or two early
+    std::size_t top = POINTS - 1;
+    for (std::size_t k = 3 * POINTS / 4; k < POINTS - 1; ++k) {
+        if (tmpl[k] > tmpl[top]) top = k;
+    }
+
+    // Foot by intersecting tangents: the tangent at the steepest point of
+    // the final upstroke meets the level of the minimum it starts from
+    std::size_t low = top;
+    while (low > 1 && tmpl[low - 1] < tmpl[low]) --low;
+    std::size_t steep = low;
+    for (std::size_t k = low + 1; k < top; ++k) {
+        if (tmpl[k + 1] - tmpl[k] > tmpl[steep + 1] - tmpl[steep]) steep = k;
+    }
+    const float slope = tmpl[steep + 1] - tmpl[steep];
+    float foot = (float)low;
+    if (slope > 0.0f) {
+        const float mid = 0.5f * (tmpl[steep] + tmpl[steep + 1]);
+        foot = (float)steep + 0.5f - (mid - tmpl[low]) / slope;
+        if (foot < (float)low) foot = (float)low;
+    }
+    out.rise_time_ms = ((float)top - foot) * ms_per_point;
+
+    // Notch: the first local minimum on the way down, before the upstroke
+    out.notch = false;
+    out.notch_ms = 0.0f;
+    for (std::size_t k = 1; k < low; ++k) {
+        if (tmpl[k] < tmpl[k - 1] && tmpl[k] <= tmpl[k + 1]) {
+            out.notch = true;
+            out.notch_ms = (float)k * ms_per_point;
+            break;
+        }
+    }
+    out.beats = blended;
+    return true;
+}
@@ -2,16 +2,608 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/printk.h>
 #include <math.h>
+#include <string.h>
+#include <atomic>
 
 #include "heart_rate.h"
-#include "hr_filter.h"
+#include "hr_pipeline.h"
+#include "beat_detector.h"
+#include "spectral_hr.h"
+#include "autocorr_hr.h"
+#include "hr_tracker.h"
+#include "spo2_estimator.h"
+#include "motion_canceller.h"
+#include "activity_monitor.h"
+#include "hrv_window.h"
+#include "rhythm_window.h"
+#include "respiration.h"
+#include "beat_template.h"
+#include "alert_engine.h"
 
 
 LOG_MODULE_REGISTER(hr_proc, LOG_LEVEL_INF);
 
 
-#define STACKSIZE 1024
+#define STACKSIZE 2048
 #define THREAD0_PRIORITY 7
+/* Accelerometer sampler: small stack, runs ahead of the HR thread */
+#define MOTION_STACKSIZE 1024
+#define MOTION_PRIORITY 6
+
+/* Samples pulled per wake-up, kept below the 32-sample MAX30102 FIFO */
+#define HR_BLOCK_MAX 24
+/* Consecutive failed reads before the state goes to HR_STATE_ERROR */
+#define HR_MAX_READ_ERRORS 10
+/* Blocks whose lowest HAL quality (SQI) is below this feed no estimator */
+#define HR_MIN_QUALITY HAL_QUALITY_POOR
+/* Accelerometer frames buffered between the sampler and the HR thread */
+#define MOTION_RING 64
+
+/* The accelerometer sampler feeds the canceller and the activity gate */
+#if defined(CONFIG_HR_MOTION_CANCEL) || defined(CONFIG_HR_ACTIVITY_GATE)
+#define HR_MOTION_INPUT 1
+#endif
+
+static hal_sensor_t *hr_sensor_dev;
+static std::atomic<int> hr_state{HR_STATE_IDLE};
+static std::atomic<float> hr_bpm{0.0f};
+static std::atomic<float> hr_bpm_var{0.0f};
+static std::atomic<bool> hr_bpm_valid{false};
+static std::atomic<float> hr_spo2{0.0f};
+static std::atomic<bool> hr_spo2_valid{false};
+static std::atomic<int> hr_quality{HAL_QUALITY_INVALID};
+static std::atomic<float> hr_resp{0.0f};
+static std::atomic<bool> hr_resp_valid{false};
+static hal_sensor_t *motion_sensor_dev;
+static_assert((int)HrMode::Suspended == HR_MODE_SUSPENDED &&
+	(int)HrMode::Count == HR_MODE_COUNT, "HrMode and hr_mode_t differ");
+static std::atomic<int> hr_mode{HR_MODE_FULL};
+static_assert((int)HrFilterProfile::DcAverage == HR_FILTER_PROFILE_DC_AVERAGE &&
+	(int)HrFilterProfile::Count == HR_FILTER_PROFILE_COUNT,
+	"HrFilterProfile and hr_filter_profile_t differ");
+static std::atomic<int> hr_filter_profile{HR_FILTER_PROFILE_FULL};
+static struct k_spinlock mode_stats_lock;
+static hr_mode_stats_t mode_stats;
+static struct k_spinlock hrv_lock;
+static hr_hrv_t hrv_latest;
+static bool hrv_latest_valid;
+static struct k_spinlock rhythm_lock;
+static hr_rhythm_t rhythm_latest;
+static bool rhythm_latest_valid;
+static bool rhythm_flagged;            /* irregular flag last reported */
+static std::atomic<hr_rhythm_cb_t> rhythm_cb{nullptr};
+static struct k_spinlock shape_lock;
+static hr_morphology_t shape_latest;
+static bool shape_latest_valid;
+static_assert(sizeof(hr_alert_rule_t) == sizeof(AlertRule) && sizeof(hr_alert_t) == sizeof(Alert) &&
+	HR_ALERT_BELOW == AlertRule::BELOW && HR_ALERT_SAMPLES == AlertRule::SAMPLES &&
+	(int)Vital::Count == HR_VITAL_COUNT, "AlertRule and hr_alert_rule_t differ");
+static struct k_spinlock alert_lock;
+static AlertEngine<CONFIG_HR_ALERT_RULES> alerts;
+static std::atomic<hr_alert_cb_t> alert_cb{nullptr};
+static std::atomic<hr_vitals_cb_t> vitals_cb{nullptr};
+
+/* Pipeline: raw PPG -> decimator -> band-pass -> beat detector
+ *                                            |-> sliding-DFT bins
+ *                                            \-> running autocorrelation
+ * and the three estimates fused by the tracker. In SpO2 mode the IR channel
+ * runs through its own decimator and band-pass in the same pass, and the
+ * ratio of ratios is taken from both channels (DC before, AC after the
+ * band-pass). With motion cancelling, the accelerometer is sampled at the
+ * pipeline rate by its own thread, band-passed like the PPG and used as the
+ * NLMS reference right after the PPG band-pass; it cleans Red only, so the
+ * SpO2 AC is taken ahead of it. The activity gate picks how
+ * much of this runs: everything, the spectral estimate only, or nothing
+ * while motion dominates. The front end of each PPG channel (decimator
+ * and band-pass) is a Pipeline over the channel's block; the rest runs by
+ * mode and is wired by hand. */
+static HrFrontEnd<HR_BLOCK_MAX> front;
+static BeatDetector detector;
+static SpectralHr spectral;
+static AutocorrHr autocorr;
+static HrTracker tracker;
+/* Up to 240 BPM over the window */
+static HrvWindow<CONFIG_HR_HRV_WINDOW_S * 4> hrv;
+static uint32_t hrv_seen;              /* detector.intervals() already taken */
+static RhythmWindow<CONFIG_HR_RHYTHM_BEATS> rhythm;
+static bool rhythm_linked;             /* the last interval went into rhythm */
+static RespirationEstimator resp;
+static BeatTemplate beat_shape;
+static uint32_t beats_seen;            /* detector.beats() already taken */
+static float *const block = front.data();
+static float block_raw[HR_BLOCK_MAX];  /* pre-band-pass copy for the baseline */
+#ifdef CONFIG_MAX30102_SPO2_MODE
+static Spo2IrPipeline<HR_BLOCK_MAX> front_ir;
+static Spo2Estimator spo2;
+static float *const block_ir = front_ir.data();
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+static MotionCanceller<CONFIG_HR_MOTION_TAPS> canceller;
+static HrFilterBank<3> motion_filter;
+#endif
+#ifdef CONFIG_HR_ACTIVITY_GATE
+static ActivityMonitor activity;
+#endif
+#ifdef HR_MOTION_INPUT
+static float motion_block[HR_BLOCK_MAX][3];
+
+/* Single-producer ring: the sampler writes frames and publishes the count,
+ * the HR thread consumes from its own tail */
+static float motion_ring[MOTION_RING][3];
+static std::atomic<uint32_t> motion_head{0};
+static std::atomic<uint32_t> motion_rate_hz{0};
+static uint32_t motion_tail;
+#endif
+
+static uint32_t sensor_rate_hz;
+static bool need_settle = true;
+static HrMode last_mode = HrMode::Full;
+#ifdef CONFIG_HR_MOTION_CANCEL
+static bool need_motion_settle = true;
+#endif
+
+static bool configure_rate(uint32_t fs_hz)
+{
+	if (!front.init(fs_hz, CONFIG_HR_PIPELINE_RATE_HZ)) {
+		return false;
+	}
+	const uint32_t rate = front.rate();
+
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	if (!front_ir.init(fs_hz, CONFIG_HR_PIPELINE_RATE_HZ)) {
+		return false;
+	}
+	spo2.init(rate);
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+	if (!motion_filter.init(rate)) {
+		return false;
+	}
+	canceller.init();
+#endif
+#ifdef CONFIG_HR_ACTIVITY_GATE
+	activity.init(rate);
+#endif
+#ifdef HR_MOTION_INPUT
+	motion_rate_hz.store(rate);
+	motion_tail = motion_head.load();
+#endif
+	detector.init(rate);
+	beat_shape.init(rate);
+	beats_seen = 0;
+	hrv.init(CONFIG_HR_HRV_WINDOW_S * 1000u);
+	hrv_seen = detector.intervals();
+	rhythm.reset();
+	rhythm_linked = false;
+	resp.init(rate);
+	tracker.reset();
+	if (!spectral.init(rate) || !autocorr.init(rate)) {
+		return false;
+	}
+	sensor_rate_hz = fs_hz;
+	need_settle = true;
+	LOG_INF("HR pipeline: %u Hz sensor, /%u -> %u Hz", fs_hz,
+		front.stage<0>().factor(), rate);
+	return true;
+}
+
+static void lose_contact(void)
+{
+	if (hr_state.load() != HR_STATE_NO_CONTACT) {
+		LOG_INF("HR: no contact");
+	}
+	hr_state.store(HR_STATE_NO_CONTACT);
+	hr_bpm_valid.store(false);
+	hr_spo2_valid.store(false);
+	hr_resp_valid.store(false);
+	detector.reset();
+	beat_shape.reset();
+	beats_seen = 0;
+	K_SPINLOCK(&shape_lock) {
+		shape_latest_valid = false;
+	}
+	resp.reset();
+	spectral.reset();
+	autocorr.reset();
+	tracker.reset();
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	spo2.reset();
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+	canceller.reset();
+#endif
+	need_settle = true;
+}
+
+/* Read up to n samples; returns how many were stored, -1 on lost contact.
+ * *quality receives the lowest HAL quality seen in the block. */
+static int read_block(size_t n, uint32_t *errors, hal_quality_t *quality)
+{
+	hal_sensor_reading_t reading;
+	size_t m = 0;
+
+	*quality = HAL_QUALITY_EXCELLENT;
+	for (size_t i = 0; i < n; ++i) {
+		if (hr_sensor_dev->ops->read(&reading) != HAL_OK) {
+			(*errors)++;
+			continue;
+		}
+		*errors = 0;
+		if (reading.quality == HAL_QUALITY_INVALID) {
+			return -1;
+		}
+		if (reading.quality < *quality) {
+			*quality = reading.quality;
+		}
+		/* Counts drop as blood volume rises: negate so systolic peaks are positive */
+#ifdef CONFIG_MAX30102_SPO2_MODE
+		block_ir[m] = -reading.y;
+#endif
+		block[m++] = -(float)reading.raw_value;
+	}
+	return (int)m;
+}
+
+#ifdef HR_MOTION_INPUT
+/* Raw accelerometer frames for the m newest pipeline samples.
+ * Both threads run on the uptime clock at the same rate, so frames are
+ * consumed one per PPG sample; if the sampler fell behind the last frame
+ * is held, if the HR thread did, the oldest frames are skipped. */
+static bool take_motion(size_t m)
+{
+	const uint32_t head = motion_head.load(std::memory_order_acquire);
+	if (head == 0) {
+		return false; /* sampler not running yet */
+	}
+	if (head - motion_tail > MOTION_RING - HR_BLOCK_MAX) {
+		motion_tail = head - (uint32_t)m;
+	}
+	for (size_t i = 0; i < m; ++i) {
+		const uint32_t k = (motion_tail != head ? motion_tail++ : head - 1) % MOTION_RING;
+		for (size_t a = 0; a < 3; ++a) {
+			motion_block[i][a] = motion_ring[k][a];
+		}
+	}
+	return true;
+}
+#endif
+
+/* Score the detector's newest beat against the template and republish
+ * the morphology. A block holds at most one beat at the pipeline rate; if
+ * it held more, the segment would span two beats and only the newest peak
+ * is kept. Returns true if the newest beat does not match the template. */
+static bool collect_shape(void)
+{
+	const uint32_t fresh = detector.beats() - beats_seen;
+	beats_seen = detector.beats();
+	if (fresh == 0 ||
+	    !beat_shape.onBeat(detector.lastPeakAge(), fresh == 1 && detector.runLength() > 0)) {
+		return false;
+	}
+
+	BeatTemplate::Beat beat;
+	BeatTemplate::Features feat;
+	const bool ok = beat_shape.lastBeat(beat) && beat_shape.features(feat);
+	K_SPINLOCK(&shape_lock) {
+		shape_latest_valid = ok;
+		if (ok) {
+			shape_latest.correlation = beat.correlation;
+			shape_latest.good_beat = beat.good;
+			shape_latest.rise_time_ms = feat.rise_time_ms;
+			shape_latest.notch_ms = feat.notch ? feat.notch_ms : 0.0f;
+		}
+	}
+	return ok && !beat.good;
+}
+
+/* Move the detector's new beats into the HRV window, the rhythm window and
+ * the respiration stage, and republish the HRV and rhythm metrics when
+ * there were any; the rhythm callback hears when the irregular flag
+ * changes. An interval closed by a beat whose shape is off is kept out of
+ * the rhythm window: an artifact there reads as irregularity. */
+static void collect_beats(bool newest_off)
+{
+	const uint32_t total = detector.intervals();
+	size_t fresh = total - hrv_seen;
+	hrv_seen = total;
+	if (fresh == 0) {
+		return;
+	}
+	if (fresh > detector.rrCount()) {
+		fresh = detector.rrCount();
+	}
+	for (size_t i = fresh; i-- > 0;) {
+		const bool successive = i + 1 < detector.runLength();
+		hrv.add(detector.rr(i), successive);
+		resp.addBeat(detector.rr(i), detector.amplitude(i));
+		if (i == 0 && newest_off) {
+			rhythm_linked = false;
+		} else {
+			rhythm.add(detector.rr(i), successive && rhythm_linked);
+			rhythm_linked = true;
+		}
+	}
+
+	RhythmWindow<CONFIG_HR_RHYTHM_BEATS>::Metrics rm;
+	const bool rhythm_ok = rhythm.metrics(rm);
+	hr_rhythm_t r{};
+	if (rhythm_ok) {
+		r.nrmssd = rm.nrmssd;
+		r.sd1_sd2 = rm.sd1_sd2;
+		r.sample_entropy = rm.sampen;
+		r.votes = rm.votes;
+		r.irregular = rm.irregular;
+		r.intervals = rm.intervals;
+	}
+	K_SPINLOCK(&rhythm_lock) {
+		rhythm_latest_valid = rhythm_ok;
+		if (rhythm_ok) {
+			rhythm_latest = r;
+		}
+	}
+	if (rhythm_ok && r.irregular != rhythm_flagged) {
+		rhythm_flagged = r.irregular;
+		const hr_rhythm_cb_t cb = rhythm_cb.load();
+		if (cb) {
+			cb(&r);
+		}
+	}
+
+	HrvWindow<CONFIG_HR_HRV_WINDOW_S * 4>::Metrics hm;
+	const bool ok = hrv.metrics(hm);
+	K_SPINLOCK(&hrv_lock) {
+		hrv_latest_valid = ok;
+		if (ok) {
+			hrv_latest.rmssd_ms = hm.rmssd_ms;
+			hrv_latest.sdnn_ms = hm.sdnn_ms;
+			hrv_latest.pnn50_pct = hm.pnn50_pct;
+			hrv_latest.intervals = hm.intervals;
+		}
+	}
+}
+
+#ifdef CONFIG_HR_MOTION_CANCEL
+/* Band-pass the frames in place, like the PPG, for the canceller */
+static void filter_motion(size_t m)
+{
+	if (need_motion_settle) {
+		for (size_t a = 0; a < 3; ++a) {
+			motion_filter[a].settle(motion_block[0][a]);
+		}
+		need_motion_settle = false;
+	}
+	for (size_t a = 0; a < 3; ++a) {
+		motion_filter[a].process(&motion_block[0][a], 3, &motion_block[0][a], 3, m);
+	}
+}
+#endif
+
+static hr_state_t process_block(size_t m, hal_quality_t quality)
+{
+	if (need_settle) {
+		/* Start from the steady state of the current DC level */
+		front.settle(block[0]);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+		front_ir.settle(block_ir[0]);
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+		need_motion_settle = true;
+#endif
+		need_settle = false;
+	}
+	/* Decimate only: the band-pass waits for the mode */
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	front_ir.run<0, 1>(m);
+#endif
+	m = front.run<0, 1>(m);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	spo2.updateDc(block, block_ir, m);
+#endif
+
+#ifdef HR_MOTION_INPUT
+	const bool have_motion = motion_sensor_dev && take_motion(m);
+#endif
+	HrMode mode = HrMode::Full;
+#ifdef CONFIG_HR_ACTIVITY_GATE
+	if (have_motion) {
+		float mag[HR_BLOCK_MAX];
+		for (size_t i = 0; i < m; ++i) {
+			const float *a = motion_block[i];
+			mag[i] = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+		}
+		mode = activity.update(mag, m);
+	}
+#endif
+	hr_mode.store((int)mode);
+	const float dt = (float)m / (float)front.rate();
+
+	if (mode == HrMode::Suspended) {
+		/* Motion dominates: no filtering and no estimates, the track ages
+		 * out instead of following garbage */
+		tracker.update(dt, NULL, 0);
+		hr_bpm_valid.store(false);
+		hr_spo2_valid.store(false);
+		hr_resp_valid.store(false);
+		last_mode = mode;
+		return HR_STATE_MOTION;
+	}
+	if (last_mode == HrMode::Suspended) {
+		/* The band-pass states are stale: restart from the current level */
+		front.stage<1>().settle(block[0]);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+		front_ir.stage<1>().settle(block_ir[0]);
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+		need_motion_settle = true;
+#endif
+	}
+	if (mode == HrMode::Full && last_mode != HrMode::Full) {
+		/* Their windows have a gap: start them over */
+		detector.reset();
+		beat_shape.reset();
+		beats_seen = 0;
+		autocorr.reset();
+		resp.reset();
+	}
+	last_mode = mode;
+
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	front_ir.run<1, 2>(m);
+#endif
+	if (mode == HrMode::Full) {
+		memcpy(block_raw, block, m * sizeof(block[0]));
+	}
+	front.run<1, 2>(m);
+	/* Garbage windows stay out of the running sums and the tracker, with
+	 * or without the motion canceller */
+	const bool usable = quality >= HR_MIN_QUALITY;
+	if (mode == HrMode::Full) {
+		/* Baseline from the band-pass residue, before the canceller */
+		resp.process(block_raw, block, m);
+	}
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	/* AC from both channels before the canceller, which only cleans Red:
+	 * the ratio of ratios needs them treated alike */
+	if (usable && mode == HrMode::Full) {
+		spo2.updateAc(block, block_ir, m);
+	}
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+	if (have_motion) {
+		filter_motion(m);
+		canceller.process(block, &motion_block[0][0], m);
+	}
+#endif
+	/* The detector keeps its own sample clock, so it sees every Full block */
+	if (mode == HrMode::Full) {
+		detector.process(block, m);
+		beat_shape.process(block, m);
+		collect_beats(collect_shape());
+	}
+
+	/* Each estimator's own confidence, scaled by the HAL signal quality.
+	 * Reduced mode runs the spectral estimate alone. */
+	const float q = (float)quality / 100.0f;
+	HrCandidate cand[3];
+	size_t nc = 0;
+	if (usable) {
+		spectral.process(block, m);
+		SpectralHr::Estimate est;
+		if (spectral.estimate(est)) {
+			cand[nc++] = { est.bpm, q * est.confidence };
+		}
+	}
+	if (usable && mode == HrMode::Full) {
+		autocorr.process(block, m);
+
+		float bpm;
+		if (detector.bpm(bpm)) {
+			cand[nc++] = { bpm, q * detector.confidence() };
+		}
+		AutocorrHr::Estimate acf;
+		if (autocorr.estimate(acf)) {
+			cand[nc++] = { acf.bpm, q * acf.score };
+		}
+	}
+	tracker.update(dt, cand, nc);
+
+	if (tracker.valid()) {
+		hr_bpm.store(tracker.bpm());
+		hr_bpm_var.store(tracker.variance());
+		hr_bpm_valid.store(true);
+	} else {
+		hr_bpm_valid.store(false);
+	}
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	Spo2Estimator::Estimate sat;
+	if (spo2.estimate(sat)) {
+		hr_spo2.store(sat.spo2);
+		hr_spo2_valid.store(true);
+	} else {
+		hr_spo2_valid.store(false);
+	}
+#endif
+	RespirationEstimator::Estimate breath;
+	if (resp.estimate(breath)) {
+		hr_resp.store(breath.brpm);
+		hr_resp_valid.store(true);
+	} else {
+		hr_resp_valid.store(false);
+	}
+	hr_quality.store(quality);
+	LOG_DBG("HR: %d BPM var %d (%u candidates)", (int)tracker.bpm(),
+		(int)tracker.variance(), (unsigned)nc);
+	return HR_STATE_RUNNING;
+}
+
+/* Charge one block's duration and processing cycles to the current mode */
+static void account_mode(size_t n, uint32_t cycles)
+{
+	const int mode = hr_mode.load();
+	K_SPINLOCK(&mode_stats_lock) {
+		mode_stats.time_ms[mode] += (uint32_t)(n * 1000 / sensor_rate_hz);
+		mode_stats.cycles[mode] += cycles;
+	}
+}
+
+/* Latest estimates to the vitals callback */
+static void publish_vitals(void)
+{
+	const hr_vitals_cb_t cb = vitals_cb.load();
+	if (!cb) {
+		return;
+	}
+	hr_vitals_t v;
+	v.bpm_valid = hr_bpm_valid.load();
+	v.bpm = v.bpm_valid ? hr_bpm.load() : 0.0f;
+	v.spo2_valid = hr_spo2_valid.load();
+	v.spo2 = v.spo2_valid ? hr_spo2.load() : 0.0f;
+	cb(&v);
+}
+
+/* Defaults until rewritten over BLE: sustained tachycardia and bradycardia,
+ * desaturation for 5 s. Durations are in seconds: the readings per second
+ * follow the sensor rate */
+static const AlertRule default_alert_rules[] = {
+	{ 1, (uint8_t)Vital::HeartRate, 0, 60, 1500, 100 },
+	{ 2, (uint8_t)Vital::HeartRate, AlertRule::BELOW, 60, 400, 50 },
+	{ 3, (uint8_t)Vital::Spo2, AlertRule::BELOW, 5, 900, 20 },
+};
+
+/* One reading per vital per block through the alert rules; an invalid
+ * estimate restarts the pending runs. Callbacks run outside the lock */
+static void check_alerts(void)
+{
+	const struct {
+		Vital vital;
+		bool valid;
+		float value;
+	} readings[] = {
+		{ Vital::HeartRate, hr_bpm_valid.load(), hr_bpm.load() },
+		{ Vital::Spo2, hr_spo2_valid.load(), hr_spo2.load() },
+		{ Vital::Respiration, hr_resp_valid.load(), hr_resp.load() },
+	};
+	const uint32_t now = k_uptime_get_32();
+	Alert fired[CONFIG_HR_ALERT_RULES];
+	size_t n = 0;
+
+	K_SPINLOCK(&alert_lock) {
+		for (const auto &r : readings) {
+			size_t k = 0;
+			alerts.update(r.vital, r.valid, (int32_t)lroundf(r.value * 10.0f), now,
+				      fired + n, &k);
+			n += k;
+		}
+	}
+	const hr_alert_cb_t cb = alert_cb.load();
+	for (size_t i = 0; i < n; ++i) {
+		LOG_WRN("HR: alert %u (vital %u, %d)", fired[i].id, fired[i].vital, fired[i].value);
+		if (cb) {
+			const hr_alert_t a = { fired[i].id, fired[i].vital, fired[i].value };
+			cb(&a);
+		}
+	}
+}
 
 static void hr_thread_entry(void *p1, void *p2, void *p3)
 {
@@ -20,23 +612,383 @@ static void hr_thread_entry(void *p1, void *p2, void *p3)
 	(void)p2;
 	(void)p3;
 
+	uint32_t errors = 0;
+	int64_t next_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
 	LOG_INF("HR thread started");
 
 	while (1) {
+		/* Follow sample-rate changes made through the HAL */
+		uint32_t fs = hal_sensor_get_sample_rate(hr_sensor_dev);
+		if (fs && fs != sensor_rate_hz && !configure_rate(fs)) {
+			LOG_ERR("HR: unsupported sample rate %u Hz", fs);
+			hr_state.store(HR_STATE_ERROR);
+			hr_bpm_valid.store(false);
+			k_sleep(K_MSEC(CONFIG_HR_BLOCK_MS));
+			continue;
+		}
 
-        //TODO: read sensor signal from hal
+		/* One block per wake-up: everything the FIFO collected since the last one */
+		size_t n = sensor_rate_hz * CONFIG_HR_BLOCK_MS / 1000;
+		if (n > HR_BLOCK_MAX) {
+			n = HR_BLOCK_MAX;
+		} else if (n == 0) {
+			n = 1;
+		}
 
-        //TODO: filter signal
+		hal_quality_t quality;
+		int m = read_block(n, &errors, &quality);
+		if (m < 0) {
+			lose_contact();
+		} else if (errors >= HR_MAX_READ_ERRORS) {
+			hr_state.store(HR_STATE_ERROR);
+			hr_bpm_valid.store(false);
+		} else if (m > 0) {
+			const uint32_t start = k_cycle_get_32();
+			hr_state.store(process_block((size_t)m, quality));
+			account_mode(n, k_cycle_get_32() - start);
+		}
+		publish_vitals();
+		check_alerts();
 
-        //TODO: compute (salience)
+		next_us += (int64_t)n * 1000000 / sensor_rate_hz;
+		k_sleep(K_TIMEOUT_ABS_US(next_us));
+	}
+}
 
-        //TODO: beats
+#ifdef CONFIG_MAX30102_SPO2_MODE
+/* SPO2 logical sensor: reads return the latest value of the HR thread */
+static hal_error_t spo2_sensor_init(void)
+{
+	return HAL_OK;
+}
 
+static hal_error_t spo2_sensor_read(hal_sensor_reading_t *reading)
+{
+	float pct;
 
-		k_sleep(K_MSEC(100)); /* placeholder delay */
+	if (!reading) {
+		return HAL_ERROR_INVALID_PARAM;
+	}
+	if (!heart_rate_get_spo2(&pct)) {
+		reading->error_code = HAL_ERROR_NO_DATA;
+		return HAL_ERROR_NO_DATA;
 	}
+	reading->timestamp = hal_get_timestamp();
+	reading->value = pct;
+	reading->raw_value = (uint32_t)(pct + 0.5f);
+	reading->x = 0.0f;
+	reading->y = 0.0f;
+	reading->z = 0.0f;
+	reading->quality = (hal_quality_t)hr_quality.load();
+	reading->error_code = HAL_OK;
+	return HAL_OK;
 }
 
+static hal_device_status_t spo2_sensor_status(void)
+{
+	return hr_state.load() == HR_STATE_ERROR ? HAL_DEVICE_STATUS_ERROR
+						 : HAL_DEVICE_STATUS_READY;
+}
+
+static const hal_sensor_ops_t spo2_ops = {
+	spo2_sensor_init,
+	spo2_sensor_read,
+	NULL,
+	NULL,
+	spo2_sensor_status,
+	NULL,
+	NULL,
+	NULL,
+};
+
+static hal_sensor_t spo2_sensor = {
+	HAL_SENSOR_TYPE_SPO2,
+	"MAX30102 SpO2 (ratio of ratios)",
+	&spo2_ops,
+	NULL,
+	true,
+};
+#endif
+
 K_THREAD_DEFINE(hr_thread_id, STACKSIZE, hr_thread_entry, NULL, NULL, NULL,
-				THREAD0_PRIORITY, 0, 0);
+				THREAD0_PRIORITY, 0, K_TICKS_FOREVER);
 
+#ifdef HR_MOTION_INPUT
+static void motion_thread_entry(void *p1, void *p2, void *p3)
+{
+	(void)p1;
+	(void)p2;
+	(void)p3;
+
+	hal_sensor_reading_t reading;
+	int64_t next_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	while (1) {
+		uint32_t rate = motion_rate_hz.load();
+		if (rate == 0) {
+			rate = CONFIG_HR_PIPELINE_RATE_HZ;
+		}
+		const uint32_t head = motion_head.load(std::memory_order_relaxed);
+		float *frame = motion_ring[head % MOTION_RING];
+		if (motion_sensor_dev->ops->read(&reading) == HAL_OK) {
+			frame[0] = reading.x;
+			frame[1] = reading.y;
+			frame[2] = reading.z;
+		} else {
+			/* Hold the previous frame: a gap would look like a jerk */
+			const float *prev = motion_ring[(head + MOTION_RING - 1) % MOTION_RING];
+			frame[0] = prev[0];
+			frame[1] = prev[1];
+			frame[2] = prev[2];
+		}
+		motion_head.store(head + 1, std::memory_order_release);
+
+		next_us += 1000000 / rate;
+		k_sleep(K_TIMEOUT_ABS_US(next_us));
+	}
+}
+
+K_THREAD_DEFINE(hr_motion_id, MOTION_STACKSIZE, motion_thread_entry, NULL, NULL, NULL,
+				MOTION_PRIORITY, 0, K_TICKS_FOREVER);
+#endif
+
+bool heart_rate_start(hal_sensor_t *hr_sensor)
+{
+	if (!hr_sensor || !hr_sensor->ops || !hr_sensor->ops->read) {
+		return false;
+	}
+	if (hr_sensor_dev) {
+		return hr_sensor_dev == hr_sensor; /* already running */
+	}
+
+	uint32_t fs = hal_sensor_get_sample_rate(hr_sensor);
+	if (!configure_rate(fs ? fs : HR_FILTER_DEFAULT_RATE_HZ)) {
+		LOG_ERR("HR: unsupported sample rate %u Hz", fs);
+		hr_state.store(HR_STATE_ERROR);
+		return false;
+	}
+
+	K_SPINLOCK(&alert_lock) {
+		for (size_t i = 0; i < ARRAY_SIZE(default_alert_rules) && i < alerts.capacity(); ++i) {
+			alerts.setRule(i, default_alert_rules[i]);
+		}
+	}
+
+	hr_sensor_dev = hr_sensor;
+#ifdef HR_MOTION_INPUT
+	if (motion_sensor_dev) {
+		k_thread_start(hr_motion_id);
+	}
+#endif
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	if (hal_sensor_register(&spo2_sensor) != HAL_OK) {
+		LOG_WRN("HR: SPO2 sensor not registered");
+	}
+#endif
+	k_thread_start(hr_thread_id);
+	return true;
+}
+
+bool heart_rate_set_motion_sensor(hal_sensor_t *accel)
+{
+#ifdef HR_MOTION_INPUT
+	if (hr_sensor_dev || !accel || !accel->ops || !accel->ops->read) {
+		return false;
+	}
+	motion_sensor_dev = accel;
+	return true;
+#else
+	(void)accel;
+	return false;
+#endif
+}
+
+bool heart_rate_get_bpm(float *bpm_out)
+{
+	return heart_rate_get_estimate(bpm_out, NULL);
+}
+
+bool heart_rate_get_estimate(float *bpm_out, float *variance_out)
+{
+	if (!bpm_out || !hr_bpm_valid.load() || hr_state.load() != HR_STATE_RUNNING) {
+		return false;
+	}
+	*bpm_out = hr_bpm.load();
+	if (variance_out) {
+		*variance_out = hr_bpm_var.load();
+	}
+	return true;
+}
+
+bool heart_rate_get_hrv(hr_hrv_t *hrv_out)
+{
+	if (!hrv_out) {
+		return false;
+	}
+	bool ok = false;
+	K_SPINLOCK(&hrv_lock) {
+		ok = hrv_latest_valid;
+		if (ok) {
+			*hrv_out = hrv_latest;
+		}
+	}
+	return ok;
+}
+
+bool heart_rate_get_rhythm(hr_rhythm_t *rhythm_out)
+{
+	if (!rhythm_out) {
+		return false;
+	}
+	bool ok = false;
+	K_SPINLOCK(&rhythm_lock) {
+		ok = rhythm_latest_valid;
+		if (ok) {
+			*rhythm_out = rhythm_latest;
+		}
+	}
+	return ok;
+}
+
+bool heart_rate_get_morphology(hr_morphology_t *shape_out)
+{
+	if (!shape_out) {
+		return false;
+	}
+	bool ok = false;
+	K_SPINLOCK(&shape_lock) {
+		ok = shape_latest_valid;
+		if (ok) {
+			*shape_out = shape_latest;
+		}
+	}
+	return ok;
+}
+
+bool heart_rate_get_respiration(float *brpm_out)
+{
+	if (!brpm_out || !hr_resp_valid.load() || hr_state.load() != HR_STATE_RUNNING) {
+		return false;
+	}
+	*brpm_out = hr_resp.load();
+	return true;
+}
+
+bool heart_rate_get_spo2(float *spo2_out)
+{
+	if (!spo2_out || !hr_spo2_valid.load() || hr_state.load() != HR_STATE_RUNNING) {
+		return false;
+	}
+	*spo2_out = hr_spo2.load();
+	return true;
+}
+
+hr_state_t heart_rate_get_state(void)
+{
+	return (hr_state_t)hr_state.load();
+}
+
+hr_mode_t heart_rate_get_mode(void)
+{
+	return (hr_mode_t)hr_mode.load();
+}
+
+bool heart_rate_set_filter_profile(hr_filter_profile_t profile)
+{
+	if ((int)profile < 0 || profile >= HR_FILTER_PROFILE_COUNT) {
+		return false;
+	}
+	/* The filters pick it up on their next block; a rate change keeps it */
+	const HrFilterProfile p = (HrFilterProfile)profile;
+	front.stage<1>().filter.setProfile(p);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+	front_ir.stage<1>().filter.setProfile(p);
+#endif
+#ifdef CONFIG_HR_MOTION_CANCEL
+	motion_filter.setProfile(p);
+#endif
+	hr_filter_profile.store((int)profile);
+	return true;
+}
+
+hr_filter_profile_t heart_rate_get_filter_profile(void)
+{
+	return (hr_filter_profile_t)hr_filter_profile.load();
+}
+
+bool heart_rate_set_alert_rule(uint8_t slot, const hr_alert_rule_t *rule)
+{
+	AlertRule r{};
+	if (rule) {
+		memcpy(&r, rule, sizeof(r));
+	}
+	bool ok = false;
+	K_SPINLOCK(&alert_lock) {
+		ok = alerts.setRule(slot, r);
+	}
+	return ok;
+}
+
+bool heart_rate_get_alert_rule(uint8_t slot, hr_alert_rule_t *rule_out)
+{
+	if (!rule_out) {
+		return false;
+	}
+	AlertRule r;
+	bool ok = false;
+	K_SPINLOCK(&alert_lock) {
+		ok = alerts.rule(slot, r);
+	}
+	if (ok) {
+		memcpy(rule_out, &r, sizeof(r));
+	}
+	return ok;
+}
+
+uint8_t heart_rate_alert_rule_count(void)
+{
+	return (uint8_t)alerts.capacity();
+}
+
+uint32_t heart_rate_get_alerts(void)
+{
+	uint32_t m = 0;
+	K_SPINLOCK(&alert_lock) {
+		m = alerts.latched();
+	}
+	return m;
+}
+
+void heart_rate_clear_alerts(void)
+{
+	K_SPINLOCK(&alert_lock) {
+		alerts.acknowledge();
+	}
+}
+
+void heart_rate_set_alert_callback(hr_alert_cb_t cb)
+{
+	alert_cb.store(cb);
+}
+
+void heart_rate_set_rhythm_callback(hr_rhythm_cb_t cb)
+{
+	rhythm_cb.store(cb);
+}
+
+void heart_rate_set_vitals_callback(hr_vitals_cb_t cb)
+{
+	vitals_cb.store(cb);
+}
+
+bool heart_rate_get_mode_stats(hr_mode_stats_t *stats_out)
+{
+	if (!stats_out) {
+		return false;
+	}
+	K_SPINLOCK(&mode_stats_lock) {
+		*stats_out = mode_stats;
+	}
+	return true;
+}
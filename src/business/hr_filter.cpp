@@ -1,31 +1,331 @@
 // hr_filter.cpp
 #include "hr_filter.h"
+#include "sos_design.h"
 
-// SOS values from design_sos.py
-// Each row is one biquad: [b0,b1,b2,a1,a2] with a0=1
-static const float SOS[3][5] = {
-    /* HP stage 1:  b0,    b1,    b2,    a1,    a2 */ 
-    { 0.967694809, -1.935389618,  0.967694809, -1.954001962,  0.954619251 },
-    /* HP stage 2:  b0,    b1,    b2,    a1,    a2 */ 
-    { 1.         , -2.         ,  1.         , -1.980323859,  0.980949464 },
-    /* LP stage 1:  b0,    b1,    b2,    a1,    a2 */ 
-    { 0.036574836,  0.073149672,  0.036574836, -1.390895281,  0.537194625 }
+#include <cmath>
+
+// Band-pass tables for every sample rate the MAX30102 supports, plus the
+// 25 Hz rate reached behind the decimator, designed at compile time.
+// Order: HP stage with lower Q first, then higher Q, then LP.
+// Each rate carries all profiles.
+struct HrFilterTable {
+    uint32_t fs_hz;
+    BiquadCascadeDF2T<3> sos;
+    BiquadCascadeDF2T<1> single;
+    float dc_pole;
+    uint8_t avg_len;
 };
 
-static BiquadCascadeDF2T<3> bp;
+static constexpr HrFilterTable hr_table(uint32_t fs_hz) {
+    return { fs_hz, sos_hr_bandpass((double)fs_hz), sos_hr_bandpass_single((double)fs_hz),
+             sos_dc_pole((double)fs_hz), sos_average_len((double)fs_hz, DcBlockAverage::MAX_LEN) };
+}
 
-void hr_filter_init() {
-    // Order: HP stage with lower Q first, then higher Q, then LP
-    for (int i=0;i<3;++i) {
-        bp.sec[i].b0 = SOS[i][0];
-        bp.sec[i].b1 = SOS[i][1];
-        bp.sec[i].b2 = SOS[i][2];
-        bp.sec[i].a1 = SOS[i][3];
-        bp.sec[i].a2 = SOS[i][4];
-        bp.sec[i].reset();
+static constexpr HrFilterTable TABLES[] = {
+    hr_table(25),
+    hr_table(50),
+    hr_table(100),
+    hr_table(200),
+    hr_table(400),
+    hr_table(800),
+    hr_table(1000),
+    hr_table(1600),
+    hr_table(3200),
+};
+
+static constexpr int NUM_TABLES = sizeof(TABLES) / sizeof(TABLES[0]);
+
+static constexpr bool tables_stable() {
+    for (const auto &t : TABLES) {
+        if (!sos_is_stable(t.sos) || !sos_is_stable(t.single)) return false;
+        if (!(t.dc_pole > 0.0f && t.dc_pole < 1.0f)) return false;
+    }
+    return true;
+}
+static_assert(tables_stable(), "unstable HR band-pass design");
+
+// DcAverage keeps the 7 Hz edge only if no table's average length is
+// clamped to the ring
+static constexpr bool averages_fit() {
+    for (const auto &t : TABLES) {
+        if (sos_average_len((double)t.fs_hz, UINT8_MAX) > DcBlockAverage::MAX_LEN) return false;
+    }
+    return true;
+}
+static_assert(averages_fit(), "DcBlockAverage::MAX_LEN too short for the fastest table");
+
+static constexpr bool profiles_cheaper() {
+    for (int p = 1; p < (int)HrFilterProfile::Count; ++p) {
+        if (hr_filter_cost((HrFilterProfile)p).ops() >= hr_filter_cost((HrFilterProfile)(p - 1)).ops()) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(profiles_cheaper(), "HR filter profiles must be listed costliest first");
+
+// Distance from the tracked input level that maps to fixed-point full
+// scale (1.0)
+#ifdef CONFIG_HR_FILTER_FULL_SCALE
+static constexpr float FULL_SCALE = CONFIG_HR_FILTER_FULL_SCALE;
+#else
+static constexpr float FULL_SCALE = 8192.0f;
+#endif
+
+#if defined(CONFIG_HR_FILTER_Q31)
+static inline int32_t to_sample(float x) {
+    return q31_sat((int64_t)(x * (2147483648.0f / FULL_SCALE)));
+}
+static inline float from_sample(int32_t y) { return (float)y * (FULL_SCALE / 2147483648.0f); }
+#elif defined(CONFIG_HR_FILTER_Q15)
+static inline int16_t to_sample(float x) {
+    int32_t v = (int32_t)(x * (32768.0f / FULL_SCALE));
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+}
+static inline float from_sample(int16_t y) { return (float)y * (FULL_SCALE / 32768.0f); }
+#else
+static inline float to_sample(float x) { return x; }
+static inline float from_sample(float y) { return y; }
+#endif
+
+static int find_table(uint32_t fs_hz) {
+    for (int i = 0; i < NUM_TABLES; ++i) {
+        if (TABLES[i].fs_hz == fs_hz) return i;
+    }
+    return -1;
+}
+
+static void load_table(HrFilter::State& st, int idx) {
+    const HrFilterTable &t = TABLES[idx];
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+    st.cascade.setCoeffs(t.sos);
+    st.section.setCoeffs(t.single);
+#else
+    st.cascade = t.sos;
+    st.section = t.single;
+#endif
+    st.average.setCoeffs(t.dc_pole, t.avg_len);
+}
+
+// Steady state of the active profile only; the others are settled when
+// switched to
+static void settle_profile(HrFilter::State& st, float x) {
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+    // x becomes the quantized zero; the steady state for it is the cleared one
+    st.offset = x;
+    st.anchored = true;
+    switch (st.profile) {
+    case HrFilterProfile::Biquad:
+        st.section.reset();
+        break;
+    case HrFilterProfile::DcAverage:
+        st.average.settle(x);
+        break;
+    default:
+        st.cascade.reset();
+        break;
+    }
+#else
+    switch (st.profile) {
+    case HrFilterProfile::Biquad:
+        st.section.settle(x);
+        break;
+    case HrFilterProfile::DcAverage:
+        st.average.settle(x);
+        break;
+    default:
+        st.cascade.settle(x);
+        break;
+    }
+#endif
+}
+
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+// Bring the tracked level within a quarter of full scale of the block's
+// first input x. Moving the level by a quantized step and the states by
+// the steady state for that step leaves the output as it was.
+template <typename C>
+static void track_offset(C& c, HrFilter::State& st, float x) {
+    const float d = x - st.offset;
+    if (!st.anchored) {
+        settle_profile(st, x);
+    } else if (std::fabs(d) > 0.25f * FULL_SCALE && std::fabs(d) < FULL_SCALE) {
+        const auto dx = to_sample(d);
+        c.rebase(dx);
+        st.offset += from_sample(dx);
+    }
+}
+
+// Converted a chunk at a time and run through the cascade's block kernel
+// (CMSIS-DSP where built), one call per HR block. A sample the range
+// cannot hold ends the chunk and re-settles the filter on it.
+template <typename C>
+static void process_fixed(C& c, HrFilter::State& st, const float* in, std::size_t in_stride,
+                          float* out, std::size_t out_stride, std::size_t n) {
+    constexpr std::size_t CHUNK = 32;
+    decltype(to_sample(0.0f)) buf[CHUNK];
+    track_offset(c, st, in[0]);
+    std::size_t i = 0;
+    while (i < n) {
+        if (!(std::fabs(in[i * in_stride] - st.offset) < FULL_SCALE)) {
+            settle_profile(st, in[i * in_stride]);
+        }
+        const float offset = st.offset;
+        std::size_t m = 0;
+        for (; m < CHUNK && i + m < n; ++m) {
+            const float d = in[(i + m) * in_stride] - offset;
+            if (!(std::fabs(d) < FULL_SCALE)) {
+                break;
+            }
+            buf[m] = to_sample(d);
+        }
+        c.processBuffer(buf, buf, m);
+        for (std::size_t k = 0; k < m; ++k) {
+            out[(i + k) * out_stride] = from_sample(buf[k]);
+        }
+        i += m;
+    }
+}
+#endif
+
+bool hr_filter_load(BiquadCascadeDF2T<3>& c, uint32_t fs_hz) {
+    int idx = find_table(fs_hz);
+    if (idx < 0) {
+        return false;
+    }
+    c = TABLES[idx].sos;
+    return true;
+}
+
+uint32_t hr_filter_decimation(uint32_t fs_hz, uint32_t target_hz, uint32_t max_factor) {
+    for (uint32_t m = max_factor; m >= 2; --m) {
+        if (fs_hz % m == 0 && fs_hz / m >= target_hz && find_table(fs_hz / m) >= 0) {
+            return m;
+        }
     }
+    return 1;
+}
+
+bool HrFilter::init(uint32_t fs_hz) {
+    int idx = find_table(fs_hz);
+    if (idx < 0) {
+        return false;
+    }
+    pending.store(-1);
+    st.last_in = 0.0f;
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+    st.offset = 0.0f;
+    st.anchored = false;
+#endif
+    st.table = idx;
+    load_table(st, idx);
+    return true;
+}
+
+bool HrFilter::init(uint32_t fs_hz, float initial) {
+    if (!init(fs_hz)) {
+        return false;
+    }
+    settle(initial);
+    return true;
+}
+
+bool HrFilter::setSampleRate(uint32_t fs_hz) {
+    int idx = find_table(fs_hz);
+    if (idx < 0) {
+        return false;
+    }
+    pending.store(idx);
+    return true;
+}
+
+void HrFilter::setProfile(HrFilterProfile p) {
+    if (p < HrFilterProfile::Count) {
+        pending_profile.store((int)p);
+    }
+}
+
+uint32_t HrFilter::sampleRate() const {
+    return st.table >= 0 ? TABLES[st.table].fs_hz : 0;
+}
+
+void HrFilter::reset() {
+    st.cascade.reset();
+    st.section.reset();
+    st.average.reset();
+    st.last_in = 0.0f;
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+    st.offset = 0.0f;
+    st.anchored = false;
+#endif
+}
+
+void HrFilter::settle(float x) {
+    settle_profile(st, x);
+    st.last_in = x;
+}
+
+void HrFilter::process(const float* in, std::size_t in_stride,
+                       float* out, std::size_t out_stride, std::size_t n) {
+    if (!in || !out || n == 0) {
+        return; // no-op if invalid
+    }
+    // Rate switches land on a block boundary, never mid-block
+    int idx = pending.exchange(-1);
+    if (idx >= 0) {
+        st.table = idx;
+        load_table(st, idx);
+    }
+    int prof = pending_profile.exchange(-1);
+    if (prof >= 0) {
+        st.profile = (HrFilterProfile)prof;
+    }
+    if (idx >= 0 || prof >= 0) {
+        settle_profile(st, st.last_in);
+    }
+    // Read before filtering: in and out may alias
+    const float last = in[(n - 1) * in_stride];
+    switch (st.profile) {
+    case HrFilterProfile::Biquad:
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+        process_fixed(st.section, st, in, in_stride, out, out_stride, n);
+#else
+        st.section.processBlock(in, in_stride, out, out_stride, n);
+#endif
+        break;
+    case HrFilterProfile::DcAverage:
+        st.average.processBlock(in, in_stride, out, out_stride, n);
+        break;
+    default:
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+        process_fixed(st.cascade, st, in, in_stride, out, out_stride, n);
+#else
+        st.cascade.processBlock(in, in_stride, out, out_stride, n);
+#endif
+        break;
+    }
+    st.last_in = last;
+}
+
+// Default instance behind the single-stream C-style API
+static HrFilter default_filter;
+
+void hr_filter_init() {
+    default_filter.init();
+}
+
+void hr_filter_init(float initial) {
+    default_filter.init(HR_FILTER_DEFAULT_RATE_HZ, initial);
 }
 
 void hr_filter_process(const float* in, float* out, std::size_t n) {
-    bp.processBuffer(in, out, n);
-}
\ No newline at end of file
+    default_filter.process(in, out, n);
+}
+
+bool hr_filter_set_sample_rate(uint32_t fs_hz) {
+    return default_filter.setSampleRate(fs_hz);
+}
+
+void hr_filter_set_profile(HrFilterProfile p) {
+    default_filter.setProfile(p);
+}
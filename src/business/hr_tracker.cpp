@@ -0,0 +1,98 @@
+// hr_tracker.cpp
+#include "hr_tracker.h"
+
+void HrTracker::reset() {
+    active = false;
+    h = v = 0.0f;
+    p00 = p01 = p11 = 0.0f;
+    disagree_s = 0.0f;
+}
+
+void HrTracker::predict(float dt) {
+    h += v * dt;
+    if (h < BPM_MIN) h = BPM_MIN;
+    if (h > BPM_MAX) h = BPM_MAX;
+    // P = F P F' + Q, F = [1 dt; 0 1], Q from white BPM/s^2 noise
+    const float dt2 = dt * dt;
+    p00 += 2.0f * dt * p01 + dt2 * p11 + Q_ACCEL * dt2 * dt / 3.0f;
+    p01 += dt * p11 + Q_ACCEL * dt2 / 2.0f;
+    p11 += Q_ACCEL * dt;
+}
+
+bool HrTracker::correct(float z, float r) {
+    const float y = z - h;
+    const float s = p00 + r;
+    if (y > MAX_JUMP_BPM || y < -MAX_JUMP_BPM || y * y > GATE * GATE * s) {
+        return false;
+    }
+    const float k0 = p00 / s, k1 = p01 / s;
+    h += k0 * y;
+    v += k1 * y;
+    if (v > MAX_SLEW) v = MAX_SLEW;
+    if (v < -MAX_SLEW) v = -MAX_SLEW;
+    p11 -= k1 * p01;
+    p01 *= 1.0f - k0;
+    p00 *= 1.0f - k0;
+    return true;
+}
+
+void HrTracker::start(float z, float r) {
+    active = true;
+    h = z;
+    v = 0.0f;
+    p00 = r;
+    p01 = 0.0f;
+    p11 = 1.0f;
+    disagree_s = 0.0f;
+}
+
+std::size_t HrTracker::update(float dt_s, const HrCandidate* c, std::size_t n) {
+    if (dt_s < 0.0f) dt_s = 0.0f;
+    if (active) {
+        predict(dt_s);
+    }
+    if (!c) {
+        n = 0;
+    }
+
+    // Most confident plausible candidate: a new track starts on it, and
+    // the rest are gated against that start
+    const HrCandidate* best = nullptr;
+    for (std::size_t i = 0; i < n; ++i) {
+        const HrCandidate& k = c[i];
+        if (k.confidence < MIN_CONF || k.bpm < BPM_MIN || k.bpm > BPM_MAX) {
+            continue;
+        }
+        if (!best || k.confidence > best->confidence) best = &k;
+    }
+
+    std::size_t accepted = 0;
+    const HrCandidate* started = nullptr;
+    if (!active) {
+        if (!best || best->confidence < INIT_CONF) {
+            return 0;
+        }
+        start(best->bpm, R_BASE / (best->confidence * best->confidence));
+        started = best;
+        accepted = 1;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const HrCandidate& k = c[i];
+        if (&k == started || k.confidence < MIN_CONF || k.bpm < BPM_MIN || k.bpm > BPM_MAX) {
+            continue;
+        }
+        if (correct(k.bpm, R_BASE / (k.confidence * k.confidence))) ++accepted;
+    }
+
+    // Confident candidates that keep missing the gate: restart on them
+    if (active && accepted == 0 && best && best->confidence >= INIT_CONF) {
+        disagree_s += dt_s;
+        if (disagree_s >= REACQUIRE_S) {
+            start(best->bpm, R_BASE / (best->confidence * best->confidence));
+            accepted = 1;
+        }
+    } else if (accepted > 0) {
+        disagree_s = 0.0f;
+    }
+    return accepted;
+}
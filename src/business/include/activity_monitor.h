@@ -0,0 +1,65 @@
+#ifndef ACTIVITY_MONITOR_H
+#define ACTIVITY_MONITOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// How much of the HR pipeline a window deserves
+enum class HrMode : uint8_t {
+    Full = 0,       // all estimators
+    Reduced,        // spectral estimate only
+    Suspended,      // no estimates, motion reported
+    Count
+};
+
+// Cheap activity level from the accelerometer magnitude stream, O(1) per
+// sample: gravity is a slow low-pass of |a| (GRAVITY_TAU_S), the activity
+// the EMA (LEVEL_TAU_S) of |a| minus gravity, in m/s^2.
+//
+// The mode follows the level with hysteresis: a mode is entered as soon as
+// the level reaches its *_ON threshold, and left for a calmer one only after
+// the level has stayed below the *_OFF threshold for HOLD_S, so walking
+// with short pauses does not toggle the pipeline. Time spent in each mode is
+// counted in samples.
+class ActivityMonitor {
+public:
+    static constexpr float GRAVITY_TAU_S = 2.0f;
+    static constexpr float LEVEL_TAU_S = 0.5f;
+    static constexpr float REDUCED_ON = 1.0f;      // m/s^2
+    static constexpr float REDUCED_OFF = 0.6f;
+    static constexpr float SUSPEND_ON = 4.0f;
+    static constexpr float SUSPEND_OFF = 2.5f;
+    static constexpr float HOLD_S = 3.0f;
+
+    ActivityMonitor() { init(50); }
+
+    // Start over at sample rate fs_hz (Hz of the magnitudes passed in)
+    void init(uint32_t fs_hz);
+
+    // Back to Full with no history; the time split is kept
+    void reset();
+
+    // Feed n magnitudes |a| in m/s^2; returns the mode after the last one
+    HrMode update(const float* mag, std::size_t n);
+
+    HrMode mode() const { return current; }
+    float level() const { return act; }
+
+    // Samples spent in mode m since init() or clearStats()
+    uint32_t samplesIn(HrMode m) const { return time_in[(std::size_t)m]; }
+    void clearStats();
+
+private:
+    uint32_t fs = 0;
+    float a_g = 0.0f, a_act = 0.0f;
+    uint32_t hold = 0;             // samples below the OFF threshold to step down
+
+    bool primed = false;
+    float gravity = 0.0f;
+    float act = 0.0f;
+    HrMode current = HrMode::Full;
+    uint32_t calm = 0;             // consecutive samples below current OFF
+    uint32_t time_in[(std::size_t)HrMode::Count]{};
+};
+
+#endif /* ACTIVITY_MONITOR_H */
@@ -0,0 +1,186 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Vital-sign alert rules evaluated incrementally: each new reading of a
+// vital steps the rules watching it, with a few bytes of state per rule and
+// no history.
+//
+// A rule is "vital above (or below) threshold for duration", the duration in
+// seconds or in consecutive readings. Values are fixed-point tenths of the
+// vital's unit (BPM, % SpO2, breaths/min). The rule goes active once the
+// condition held for the whole duration, and stays active until the value
+// is past the threshold by more than the hysteresis in the other direction.
+// Going active raises the alert: update() reports it once and it stays
+// latched until acknowledge(). A still-active rule fires again only after
+// it released. A missing reading (estimate invalid) restarts the pending
+// duration but leaves an active rule as it is.
+//
+// The rule layout is the BLE wire format: 8 bytes, little-endian.
+enum class Vital : uint8_t {
+    HeartRate = 0,
+    Spo2,
+    Respiration,
+    Count
+};
+
+struct AlertRule {
+    uint8_t id;                 // reported with the alert, 0 = empty slot
+    uint8_t vital;              // Vital
+    uint8_t flags;              // BELOW, SAMPLES
+    uint8_t duration;           // seconds, or readings with SAMPLES
+    int16_t threshold;          // tenths
+    uint16_t hysteresis;        // tenths
+
+    static constexpr uint8_t BELOW = 0x01;      // alert below the threshold
+    static constexpr uint8_t SAMPLES = 0x02;    // duration counts readings
+};
+static_assert(sizeof(AlertRule) == 8, "AlertRule is the wire format");
+
+struct Alert {
+    uint8_t id;
+    uint8_t vital;
+    int16_t value;              // tenths, the reading that raised it
+};
+
+template <std::size_t MaxRules>
+class AlertEngine {
+public:
+    static_assert(MaxRules >= 1 && MaxRules <= 32, "rule masks are 32 bits");
+
+    AlertEngine() { clear(); }
+
+    // Drop every rule
+    void clear() {
+        for (std::size_t i = 0; i < MaxRules; ++i) {
+            rules[i] = AlertRule{};
+            st[i] = State{};
+        }
+        for (auto &m : watch) m = 0;
+        latch = 0;
+    }
+
+    static constexpr std::size_t capacity() { return MaxRules; }
+
+    // Install rule r in slot (an id of 0 empties it); the slot's state and
+    // latched alert start over. False for a bad slot or vital.
+    bool setRule(std::size_t slot, const AlertRule& r) {
+        if (slot >= MaxRules || (r.id != 0 && r.vital >= (uint8_t)Vital::Count) ||
+            (r.flags & ~(AlertRule::BELOW | AlertRule::SAMPLES)) != 0) {
+            return false;
+        }
+        const uint32_t bit = 1u << slot;
+        for (auto &m : watch) m &= ~bit;
+        latch &= ~bit;
+        st[slot] = State{};
+        rules[slot] = r;
+        if (r.id != 0) {
+            watch[r.vital] |= bit;
+        }
+        return true;
+    }
+
+    bool rule(std::size_t slot, AlertRule& out) const {
+        if (slot >= MaxRules) {
+            return false;
+        }
+        out = rules[slot];
+        return true;
+    }
+
+    // A reading of vital v in tenths at now_ms, or valid = false if there is
+    // no estimate. Returns the slots whose alert was raised by it; fired[]
+    // (room for MaxRules, may be null) receives them in slot order.
+    uint32_t update(Vital v, bool valid, int32_t value, uint32_t now_ms,
+                    Alert* fired = nullptr, std::size_t* n_fired = nullptr) {
+        uint32_t raised = 0;
+        std::size_t n = 0;
+        if ((std::size_t)v >= (std::size_t)Vital::Count) {
+            return 0;
+        }
+        for (uint32_t m = watch[(std::size_t)v]; m != 0; m &= m - 1) {
+            const std::size_t i = (std::size_t)__builtin_ctz(m);
+            if (step(rules[i], st[i], valid, value, now_ms)) {
+                raised |= 1u << i;
+                if (fired) {
+                    fired[n++] = Alert{rules[i].id, rules[i].vital, clamp16(value)};
+                }
+            }
+        }
+        latch |= raised;
+        if (n_fired) {
+            *n_fired = n;
+        }
+        return raised;
+    }
+
+    // Raised and not yet acknowledged
+    uint32_t latched() const { return latch; }
+
+    // Condition currently holding (past the duration, not yet released)
+    uint32_t active() const {
+        uint32_t m = 0;
+        for (std::size_t i = 0; i < MaxRules; ++i) {
+            if (st[i].active) m |= 1u << i;
+        }
+        return m;
+    }
+
+    // Clear the latched alerts; active rules stay active
+    void acknowledge() { latch = 0; }
+
+private:
+    struct State {
+        uint32_t since_ms = 0;  // first reading of the pending run
+        uint8_t count = 0;      // readings in the pending run, saturating
+        bool active = false;
+    };
+
+    static int16_t clamp16(int32_t v) {
+        return (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+    }
+
+    // One reading through one rule; true if the rule went active
+    static bool step(const AlertRule& r, State& s, bool valid, int32_t value, uint32_t now_ms) {
+        if (!valid) {
+            s.count = 0;
+            return false;
+        }
+        const bool below = (r.flags & AlertRule::BELOW) != 0;
+        if (s.active) {
+            const int32_t release = below ? (int32_t)r.threshold + r.hysteresis
+                                          : (int32_t)r.threshold - r.hysteresis;
+            if (below ? value > release : value < release) {
+                s.active = false;
+                s.count = 0;
+            }
+            return false;
+        }
+        if (!(below ? value < r.threshold : value > r.threshold)) {
+            s.count = 0;
+            return false;
+        }
+        if (s.count == 0) {
+            s.since_ms = now_ms;
+        }
+        if (s.count < UINT8_MAX) {
+            ++s.count;
+        }
+        const bool held = (r.flags & AlertRule::SAMPLES) != 0
+            ? s.count >= r.duration
+            : now_ms - s.since_ms >= (uint32_t)r.duration * 1000u;
+        if (held) {
+            s.active = true;
+        }
+        return held;
+    }
+
+    AlertRule rules[MaxRules];
+    State st[MaxRules];
+    uint32_t watch[(std::size_t)Vital::Count];  // slots per vital
+    uint32_t latch = 0;
+};
+
+#endif /* ALERT_ENGINE_H */
@@ -0,0 +1,68 @@
+#ifndef AUTOCORR_HR_H
+#define AUTOCORR_HR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Periodicity-based BPM estimate from running autocorrelation sums over the
+// lags of BPM_MIN..BPM_MAX, fed with the hr_filter output.
+//
+// Every lag sum is exponentially weighted (time constant TAU_S) and updated
+// with one MAC per lag per sample from a ring of past samples, instead of an
+// O(N*L) correlation per window. Works on weak, low-perfusion pulses where
+// individual peaks are lost in noise: the shortest lag whose local maximum
+// reaches PEAK_FRACTION of the best one is taken (so multiples of the
+// period do not win), refined by parabolic interpolation, and scored by
+// R[lag] / R[0].
+class AutocorrHr {
+public:
+    static constexpr float BPM_MIN = 30.0f;
+    static constexpr float BPM_MAX = 220.0f;
+    static constexpr float TAU_S = 4.0f;
+    static constexpr float PEAK_FRACTION = 0.9f;
+    static constexpr std::size_t LAG_MAX = 200;   // 30 BPM at 100 Hz
+
+    struct Estimate {
+        float bpm;
+        float score;        // normalized periodicity, 0..1
+    };
+
+    AutocorrHr() { init(50); }
+
+    // Returns false if the lag range for fs_hz exceeds LAG_MAX
+    bool init(uint32_t fs_hz);
+
+    // Clear the sums and history, keep the rate
+    void reset();
+
+    void process(const float* x, std::size_t n);
+
+    // Best lag as BPM; false until the sums cover the longest lag plus one
+    // time constant, or if no lag correlates positively
+    bool estimate(Estimate& out) const;
+
+    std::size_t lagMin() const { return lag_lo; }
+    std::size_t lagMax() const { return lag_hi; }
+
+private:
+    // Parabolic peak at lag l; false if l is not a local maximum
+    bool refine(std::size_t l, float& delta, float& peak) const;
+
+    static constexpr std::size_t RING = 256;
+    static_assert((RING & (RING - 1)) == 0, "ring size must be a power of two");
+    static_assert(RING > LAG_MAX + 1, "ring must hold the longest lag");
+
+    uint32_t fs = 0;
+    float lambda = 0.0f;           // per-sample forgetting factor
+    std::size_t lag_lo = 0;        // BPM_MAX
+    std::size_t lag_hi = 0;        // BPM_MIN
+    std::size_t warmup = 0;        // samples before estimate() is valid
+
+    float r0 = 0.0f;
+    float r[LAG_MAX + 2]{};        // lag_lo - 1 .. lag_hi + 1 are maintained
+    float hist[RING]{};
+    std::size_t pos = 0;           // slot of the newest sample
+    std::size_t seen = 0;          // saturates at warmup
+};
+
+#endif /* AUTOCORR_HR_H */
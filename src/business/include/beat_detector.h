@@ -0,0 +1,108 @@
+#ifndef BEAT_DETECTOR_H
+#define BEAT_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Streaming systolic-peak detector over the band-passed PPG (hr_filter
+// output, systolic peaks positive). O(1) work and no allocation per sample:
+//
+//  - adaptive threshold: a candidate must reach THRESHOLD * envelope, where
+//    the envelope follows the peak heights and decays with ENVELOPE_TAU_S;
+//  - slope test: the upstroke leading to the peak must be at least
+//    SLOPE_FRACTION of the average accepted upstroke (rejects the dicrotic
+//    wave and slow baseline bumps);
+//  - refractory period: max(REFRACTORY_MIN_MS, half the last RR).
+//
+// Peak positions are refined to a fraction of a sample (parabolic fit), RR
+// intervals land in a fixed-size ring, next to the peak-to-trough height of
+// the beat that closed each one, and the BPM is the median of the last
+// MEDIAN_LEN intervals.
+class BeatDetector {
+public:
+    static constexpr std::size_t RR_RING = 16;
+    static constexpr std::size_t MEDIAN_LEN = 5;
+
+    static constexpr float THRESHOLD = 0.5f;
+    static constexpr float ENVELOPE_TAU_S = 2.0f;
+    static constexpr float SLOPE_FRACTION = 0.4f;
+    static constexpr uint32_t REFRACTORY_MIN_MS = 250;  // 240 BPM
+    static constexpr uint32_t RR_MAX_MS = 2000;         // 30 BPM
+    static constexpr uint32_t BEAT_TIMEOUT_MS = 3000;   // no beat: estimate invalid
+    static constexpr std::size_t MIN_VALID_RR = 3;       // consecutive RRs before reporting
+
+    BeatDetector() { init(50); }
+
+    // Start over at sample rate fs_hz (Hz of the samples passed to process())
+    void init(uint32_t fs_hz);
+
+    // Forget beats and envelopes, keep the rate
+    void reset();
+
+    // Feed n filtered samples; returns the number of beats found in them
+    std::size_t process(const float* x, std::size_t n);
+
+    // Median-of-recent-RR heart rate; false until MIN_VALID_RR consecutive
+    // plausible intervals are seen, or after BEAT_TIMEOUT_MS without a beat
+    bool bpm(float& out) const;
+
+    // RR regularity over the same intervals: 1 - (max - min) / median,
+    // clamped to 0..1; 0 while bpm() is invalid
+    float confidence() const;
+
+    // RR ring access, i = 0 is the newest interval (ms)
+    std::size_t rrCount() const { return rr_count; }
+    uint16_t rr(std::size_t i) const;
+
+    // Peak height over the lowest sample since the previous beat, for the
+    // beat that closed rr(i)
+    float amplitude(std::size_t i) const;
+
+    // RR intervals recorded since construction; never decreases, so a
+    // consumer can pick up the new ones across reset() and init()
+    uint32_t intervals() const { return rr_total; }
+
+    // Newest intervals that follow each other without a gap (saturates at
+    // RR_RING); rr(i) and rr(i + 1) are successive beats iff i + 1 < runLength()
+    std::size_t runLength() const { return run; }
+
+    // Samples from the newest beat's refined peak to the newest sample
+    // passed to process(); only meaningful once beats() > 0
+    float lastPeakAge() const { return (float)(n - 1 - last_n) - last_frac; }
+
+    uint32_t sampleRate() const { return fs; }
+    uint32_t beats() const { return beat_count; }
+
+private:
+    void onPeak(float frac, float slope, float height);
+
+    uint32_t fs = 0;
+    float env_decay = 0.0f;
+    uint32_t refractory_min = 0;   // samples
+    uint32_t rr_max = 0;           // samples
+    uint32_t timeout = 0;          // samples
+
+    // Signal history
+    uint32_t n = 0;                // samples seen
+    float x1 = 0.0f, x2 = 0.0f;    // previous two samples
+    float env = 0.0f;
+    float rise_slope = 0.0f;       // steepest slope of the current upstroke
+    float slope_avg = 0.0f;
+    float trough = 0.0f;           // lowest sample since the last beat
+
+    // Beats
+    bool have_last = false;
+    uint32_t last_n = 0;           // integer sample of the last beat
+    float last_frac = 0.0f;        // sub-sample offset of the last beat
+    uint32_t last_rr = 0;          // samples
+    uint32_t beat_count = 0;
+    std::size_t run = 0;           // consecutive plausible RRs
+
+    uint16_t rr_ring[RR_RING]{};
+    float amp_ring[RR_RING]{};
+    std::size_t rr_head = 0;       // next write slot
+    std::size_t rr_count = 0;
+    uint32_t rr_total = 0;
+};
+
+#endif /* BEAT_DETECTOR_H */
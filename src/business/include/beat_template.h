@@ -0,0 +1,97 @@
+#ifndef BEAT_TEMPLATE_H
+#define BEAT_TEMPLATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "window_stats.h"
+
+// Ensemble-averaged beat shape over the band-passed PPG, for a beat-level
+// quality flag and morphology features without keeping waveforms.
+//
+// The stage keeps the newest RING filtered samples. On every beat the
+// detector reports, the segment from the previous systolic peak to this one
+// is resampled to POINTS points (linear interpolation at the refined peak
+// positions, so point 0 and POINTS - 1 are both peaks) and normalized to
+// zero mean and unit RMS. Its Pearson correlation with the template is the
+// beat's score. Beats scoring at least BLEND_CORR are blended into the
+// template with weight ALPHA; the first LEARN_BEATS are averaged with equal
+// weight to start it. RELEARN_AFTER rejected beats in a row mean the
+// template no longer fits (new sensor position, new rhythm): it starts over
+// from the newest beat.
+//
+// Features come from the template, in ms from the mean RR of the blended
+// beats: the rise time from the foot to the systolic peak, and the
+// dicrotic notch as the first local minimum after the peak, before the
+// upstroke. The foot is where the tangent at the steepest point of the
+// upstroke meets the level of the minimum the upstroke starts from
+// (intersecting tangents). The band-pass keeps the notch only where the
+// dicrotic wave is strong enough, so it may be missing.
+class BeatTemplate {
+public:
+    static constexpr std::size_t POINTS = 64;
+    static constexpr std::size_t RING = 256;      // >= 2 s at 100 Hz plus a block
+    static constexpr float ALPHA = 0.1f;
+    static constexpr std::size_t LEARN_BEATS = 4;
+    static constexpr float BLEND_CORR = 0.8f;
+    static constexpr float GOOD_CORR = 0.9f;
+    static constexpr std::size_t RELEARN_AFTER = 8;
+
+    struct Beat {
+        float correlation;      // against the template before blending, -1..1
+        bool good;              // correlation >= GOOD_CORR
+    };
+
+    struct Features {
+        float rise_time_ms;     // foot to systolic peak
+        float notch_ms;         // systolic peak to dicrotic notch, 0 if none
+        bool notch;             // the template shows a notch
+        uint32_t beats;         // beats blended since the template started
+    };
+
+    BeatTemplate() { init(50); }
+
+    // Start over at sample rate fs_hz (Hz of the samples passed to process())
+    void init(uint32_t fs_hz);
+
+    // Forget the samples and the template, keep the rate
+    void reset();
+
+    // The same band-passed samples the beat detector sees
+    void process(const float* x, std::size_t n);
+
+    // A beat whose peak lies peak_age samples before the newest sample
+    // (BeatDetector::lastPeakAge()). adjacent: the previous beat passed here
+    // is the one just before it. Returns true if the beat was scored.
+    bool onBeat(float peak_age, bool adjacent);
+
+    // Score of the newest scored beat; false until one was scored
+    bool lastBeat(Beat& out) const;
+
+    // False until LEARN_BEATS beats built the template
+    bool features(Features& out) const;
+
+    // The template, POINTS points, peak to peak
+    const float* shape() const { return tmpl; }
+
+private:
+    bool resample(uint32_t from, float frac, float len, float* out) const;
+    void start(const float* beat, float len);
+
+    uint32_t fs = 0;
+    SampleRing<RING> ring;
+
+    bool have_peak = false;
+    uint32_t peak_idx = 0;          // previous peak: ring index ...
+    float peak_frac = 0.0f;         // ... plus 0..1 sample
+
+    float tmpl[POINTS]{};
+    uint32_t blended = 0;
+    std::size_t rejects = 0;
+    float rr_avg = 0.0f;            // samples
+
+    bool have_score = false;
+    Beat last{};
+};
+
+#endif /* BEAT_TEMPLATE_H */
@@ -0,0 +1,213 @@
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+// CMSIS-DSP backend: on targets that build the CMSIS-DSP filtering module the
+// cascades dispatch to the hand-tuned kernels; native_sim and anything else
+// use the portable loops below, which stay the reference for host tests.
+#if defined(CONFIG_CMSIS_DSP) && defined(CONFIG_CMSIS_DSP_FILTERING)
+#include <arm_math.h>
+#define BIQUAD_HAS_CMSIS 1
+#else
+#define BIQUAD_HAS_CMSIS 0
+#endif
+
+struct BiquadDF2T
+{
+    // Direct form II
+    // y[n] = a0*x[n] + a1*x[n-1] + a2*x[n-2] – b1*y[n-1] – b2*y[n-2]
+    float b0=0, b1=0, b2=0, a1=0, a2=0;
+    float s1=0, s2=0; // two delay states (transposed)
+
+    inline float process(float x) {
+        float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        return y;
+    }
+    inline void reset() noexcept { s1 = 0.0f; s2 = 0.0f; }
+
+    // Load the state reached after a long constant input x (steady state,
+    // as scipy's lfilter_zi) and return the section's output level.
+    inline float settle(float x) noexcept {
+        const float den = 1.0f + a1 + a2;
+        const float y = den != 0.0f ? (b0 + b1 + b2) * x / den : 0.0f;
+        s2 = b2 * x - a2 * y;
+        s1 = b1 * x - a1 * y + s2;
+        return y;
+    }
+};
+
+template <std::size_t N>
+struct BiquadCascadeDF2T {
+    std::array<BiquadDF2T, N> sec{};
+
+    inline float process(float x) {
+        for (auto &s : sec) x = s.process(x);
+        return x;
+    }
+
+    inline void processBuffer(const float* in, float* out, std::size_t len) {
+#if BIQUAD_HAS_CMSIS
+        processBufferCmsis(in, out, len);
+#else
+        processBufferPortable(in, out, len);
+#endif
+    }
+
+    inline void processBufferPortable(const float* in, float* out, std::size_t len) {
+        if (!in || !out) {
+            return; // no-op if invalid
+        }
+        for (std::size_t i = 0; i < len; ++i) {
+            float y = in[i];
+            for (auto &s : sec) y = s.process(y);
+            out[i] = y;
+        }
+    }
+
+#if BIQUAD_HAS_CMSIS
+    // arm_biquad_cascade_df2T_f32 runs the same DF2T recurrence but wants
+    // [b0,b1,b2,-a1,-a2] per stage and packed [s1,s2] pairs. Both are packed
+    // around the call (O(N) per block); in == out is allowed.
+    inline void processBufferCmsis(const float* in, float* out, std::size_t len) {
+        if (!in || !out || len == 0) {
+            return; // no-op if invalid
+        }
+        float32_t coeffs[5 * N];
+        float32_t state[2 * N];
+        for (std::size_t k = 0; k < N; ++k) {
+            coeffs[5 * k + 0] = sec[k].b0;
+            coeffs[5 * k + 1] = sec[k].b1;
+            coeffs[5 * k + 2] = sec[k].b2;
+            coeffs[5 * k + 3] = -sec[k].a1;
+            coeffs[5 * k + 4] = -sec[k].a2;
+            state[2 * k + 0] = sec[k].s1;
+            state[2 * k + 1] = sec[k].s2;
+        }
+        // Fill the instance directly: the _init_ helper would zero the state
+        arm_biquad_cascade_df2T_instance_f32 inst;
+        inst.numStages = (uint8_t)N;
+        inst.pState = state;
+        inst.pCoeffs = coeffs;
+        arm_biquad_cascade_df2T_f32(&inst, in, out, (uint32_t)len);
+        for (std::size_t k = 0; k < N; ++k) {
+            sec[k].s1 = state[2 * k + 0];
+            sec[k].s2 = state[2 * k + 1];
+        }
+    }
+#endif
+
+    // Per-sample cost of processBlock(), per section: 5 mul, 4 add, and 2
+    // memory accesses (input, output)
+    static constexpr std::size_t MUL = 5 * N, ADD = 4 * N, MEM = 2 * N;
+
+    // Section-major block kernel: the whole block runs through section 0,
+    // then section 1, ... so each section's coefficients and states stay in
+    // registers instead of being reloaded per sample. Reads in[i*in_stride],
+    // writes out[i*out_stride]; in == out (same stride) filters in place, and
+    // a stride of 2 reads one channel of interleaved Red/IR frames directly.
+    inline void processBlock(const float* in, std::size_t in_stride,
+                             float* out, std::size_t out_stride, std::size_t len) noexcept {
+        if (!in || !out || len == 0) {
+            return; // no-op if invalid
+        }
+#if BIQUAD_HAS_CMSIS
+        if (in_stride == 1 && out_stride == 1) {
+            processBufferCmsis(in, out, len);
+            return;
+        }
+#endif
+        for (std::size_t k = 0; k < N; ++k) {
+            BiquadDF2T &q = sec[k];
+            const float b0 = q.b0, b1 = q.b1, b2 = q.b2, a1 = q.a1, a2 = q.a2;
+            float s1 = q.s1, s2 = q.s2;
+            const float* src = (k == 0) ? in : out;
+            const std::size_t src_stride = (k == 0) ? in_stride : out_stride;
+            for (std::size_t i = 0; i < len; ++i) {
+                const float x = src[i * src_stride];
+                const float y = b0 * x + s1;
+                s1 = b1 * x - a1 * y + s2;
+                s2 = b2 * x - a2 * y;
+                out[i * out_stride] = y;
+            }
+            q.s1 = s1;
+            q.s2 = s2;
+        }
+    }
+
+    inline void processBlock(float* data, std::size_t len, std::size_t stride = 1) noexcept {
+        processBlock(data, stride, data, stride, len);
+    }
+
+    inline void reset() noexcept { for (auto &s : sec) s.reset(); }
+
+    // Steady state for a constant input x through all sections
+    inline float settle(float x) noexcept {
+        for (auto &s : sec) x = s.settle(x);
+        return x;
+    }
+};
+
+// C channels filtered in lockstep (e.g. Red, IR, accel X/Y/Z).
+// Coefficients and states are kept structure-of-arrays per section so the
+// per-channel inner loop is contiguous: auto-vectorizes on the host and maps
+// onto paired MACs on Cortex-M4. Buffers are interleaved frames of C samples.
+template <std::size_t N, std::size_t C>
+struct BiquadCascadeMultiDF2T {
+    struct Section {
+        float b0[C]{}, b1[C]{}, b2[C]{}, a1[C]{}, a2[C]{};
+        float s1[C]{}, s2[C]{};
+    };
+    std::array<Section, N> sec{};
+
+    // Load one section for a single channel from a scalar biquad
+    inline void setSection(std::size_t i, std::size_t ch, const BiquadDF2T& q) noexcept {
+        if (i >= N || ch >= C) return;
+        Section &s = sec[i];
+        s.b0[ch] = q.b0; s.b1[ch] = q.b1; s.b2[ch] = q.b2;
+        s.a1[ch] = q.a1; s.a2[ch] = q.a2;
+    }
+
+    // Load one section with the same coefficients on every channel
+    inline void setSection(std::size_t i, const BiquadDF2T& q) noexcept {
+        for (std::size_t ch = 0; ch < C; ++ch) setSection(i, ch, q);
+    }
+
+    // Filter one frame of C samples in place
+    inline void processFrame(float* x) noexcept {
+        for (auto &s : sec) {
+            for (std::size_t c = 0; c < C; ++c) {
+                const float xi = x[c];
+                const float y = s.b0[c] * xi + s.s1[c];
+                s.s1[c] = s.b1[c] * xi - s.a1[c] * y + s.s2[c];
+                s.s2[c] = s.b2[c] * xi - s.a2[c] * y;
+                x[c] = y;
+            }
+        }
+    }
+
+    // in/out hold `frames` interleaved frames of C samples; may alias
+    inline void processBuffer(const float* in, float* out, std::size_t frames) {
+        if (!in || !out) {
+            return; // no-op if invalid
+        }
+        for (std::size_t f = 0; f < frames; ++f) {
+            float y[C];
+            for (std::size_t c = 0; c < C; ++c) y[c] = in[f * C + c];
+            processFrame(y);
+            for (std::size_t c = 0; c < C; ++c) out[f * C + c] = y[c];
+        }
+    }
+
+    inline void reset() noexcept {
+        for (auto &s : sec) {
+            for (std::size_t c = 0; c < C; ++c) { s.s1[c] = 0.0f; s.s2[c] = 0.0f; }
+        }
+    }
+};
+
+#endif /* BIQUAD_H */
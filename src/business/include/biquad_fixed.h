@@ -0,0 +1,279 @@
+#ifndef BIQUAD_FIXED_H
+#define BIQUAD_FIXED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+#include "biquad.h"
+
+// Fixed-point DF2T biquads for FPU-less (or FPU-off) operation.
+//
+// Coefficients are Q2.30 so |a1| up to 2 fits; data and states are Q1.31.
+// Every product is accumulated in 64 bits with saturating adds, and the
+// bits dropped when a state is requantized to Q31 are fed back into the
+// next update of that state (first-order error feedback). Without the
+// feedback the HP sections (poles at ~0.98 radius) turn truncation noise
+// into a DC offset and limit cycles.
+
+inline int32_t q31_sat(int64_t v) noexcept {
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+inline int64_t q31_add_sat(int64_t a, int64_t b) noexcept {
+    int64_t r;
+    if (__builtin_add_overflow(a, b, &r)) {
+        return b > 0 ? INT64_MAX : INT64_MIN;
+    }
+    return r;
+}
+
+// Float coefficient to Q2.30 with rounding; clamps to [-2, 2)
+inline int32_t q30_from_float(float c) noexcept {
+    const float scaled = c * 1073741824.0f;
+    return q31_sat((int64_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f)));
+}
+
+struct BiquadQ31
+{
+    static constexpr int COEF_SHIFT = 30;
+
+    int32_t b0=0, b1=0, b2=0, a1=0, a2=0; // Q2.30
+    int32_t s1=0, s2=0;                   // Q1.31 delay states
+    int64_t e1=0, e2=0;                   // requantization residues
+
+    inline void setCoeffs(const BiquadDF2T& f) noexcept {
+        b0 = q30_from_float(f.b0);
+        b1 = q30_from_float(f.b1);
+        b2 = q30_from_float(f.b2);
+        a1 = q30_from_float(f.a1);
+        a2 = q30_from_float(f.a2);
+    }
+
+    inline int32_t process(int32_t x) {
+        const int64_t xs = x;
+        int64_t acc = q31_add_sat(b0 * xs, (int64_t)s1 << COEF_SHIFT);
+        const int32_t y = q31_sat((acc + (INT64_C(1) << (COEF_SHIFT - 1))) >> COEF_SHIFT);
+        const int64_t ys = y;
+
+        acc = q31_add_sat(b1 * xs, -(a1 * ys));
+        acc = q31_add_sat(acc, (int64_t)s2 << COEF_SHIFT);
+        acc = q31_add_sat(acc, e1);
+        s1 = requantize(acc, e1);
+
+        acc = q31_add_sat(b2 * xs, -(a2 * ys));
+        acc = q31_add_sat(acc, e2);
+        s2 = requantize(acc, e2);
+        return y;
+    }
+
+    inline void reset() noexcept { s1 = 0; s2 = 0; e1 = 0; e2 = 0; }
+
+    // Steady state for a constant input x; returns the output level
+    inline int32_t settle(int32_t x) noexcept {
+        const int32_t y = dcLevel(x);
+        e1 = 0;
+        e2 = 0;
+        steadyState(x, y, s1, s2, e1, e2);
+        return y;
+    }
+
+    // Move the input reference by dx: the states become those for the same
+    // past input minus dx, so feeding x - dx from now on gives the output x
+    // would have, less the DC gain times dx. Returns that output shift.
+    inline int32_t rebase(int32_t dx) noexcept {
+        const int32_t y = dcLevel(dx);
+        int32_t d1, d2;
+        int64_t r1 = 0, r2 = 0;
+        steadyState(dx, y, d1, d2, r1, r2);
+        s1 = q31_sat((int64_t)s1 - d1);
+        s2 = q31_sat((int64_t)s2 - d2);
+        return y;
+    }
+
+private:
+    // Output level for a constant input x
+    inline int32_t dcLevel(int32_t x) const noexcept {
+        const int64_t den = (INT64_C(1) << COEF_SHIFT) + a1 + a2;
+        const int64_t num = (int64_t)b0 + b1 + b2;
+        // DC gain in Q30, clamped so gain * x cannot overflow 64 bits
+        int64_t g = den != 0 ? (num << COEF_SHIFT) / den : 0;
+        if (g > (INT64_C(1) << 32)) g = INT64_C(1) << 32;
+        if (g < -(INT64_C(1) << 32)) g = -(INT64_C(1) << 32);
+        return q31_sat((g * x) >> COEF_SHIFT);
+    }
+
+    // States for constant input x and output y
+    inline void steadyState(int32_t x, int32_t y, int32_t& t1, int32_t& t2,
+                            int64_t& r1, int64_t& r2) const noexcept {
+        const int64_t xs = x, ys = y;
+        t2 = requantize(q31_add_sat(b2 * xs, -(a2 * ys)), r2);
+        t1 = requantize(q31_add_sat(q31_add_sat(b1 * xs, -(a1 * ys)),
+                                    (int64_t)t2 << COEF_SHIFT), r1);
+    }
+
+    // Q3.61 accumulator to Q1.31 state; keeps the dropped bits in err
+    static inline int32_t requantize(int64_t acc, int64_t& err) noexcept {
+        const int64_t q = acc >> COEF_SHIFT;
+        const int32_t s = q31_sat(q);
+        // On saturation the residue is meaningless; drop it
+        err = (q == s) ? acc - ((int64_t)s << COEF_SHIFT) : 0;
+        return s;
+    }
+};
+
+template <std::size_t N>
+struct BiquadCascadeQ31 {
+    std::array<BiquadQ31, N> sec{};
+#if BIQUAD_HAS_CMSIS
+    // arm_biquad_cas_df1_32x64_q31 is Direct Form I with 64-bit feedback
+    // state: per stage x[n-1], x[n-2] (Q31 in q63 slots) and y[n-1], y[n-2]
+    // in Q1.63. In CMSIS builds this is the live state of the cascade.
+    std::array<q63_t, 4 * N> df1{};
+    // [b0,b1,b2,-a1,-a2] per stage, packed once by setCoeffs(). Q2.30 is
+    // CMSIS Q31 with postShift = 1.
+    std::array<q31_t, 5 * N> df1_coeffs{};
+#endif
+
+    // Quantize the coefficients of a float cascade; states are cleared
+    inline void setCoeffs(const BiquadCascadeDF2T<N>& f) noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            sec[i].setCoeffs(f.sec[i]);
+        }
+#if BIQUAD_HAS_CMSIS
+        for (std::size_t k = 0; k < N; ++k) {
+            df1_coeffs[5 * k + 0] = sec[k].b0;
+            df1_coeffs[5 * k + 1] = sec[k].b1;
+            df1_coeffs[5 * k + 2] = sec[k].b2;
+            df1_coeffs[5 * k + 3] = q31_sat(-(int64_t)sec[k].a1);
+            df1_coeffs[5 * k + 4] = q31_sat(-(int64_t)sec[k].a2);
+        }
+#endif
+        reset();
+    }
+
+    // One sample; block callers should use processBuffer(), which reaches
+    // the CMSIS kernel once per block
+    inline int32_t process(int32_t x) {
+#if BIQUAD_HAS_CMSIS
+        processBufferCmsis(&x, &x, 1);
+        return x;
+#else
+        for (auto &s : sec) x = s.process(x);
+        return x;
+#endif
+    }
+
+    inline void processBuffer(const int32_t* in, int32_t* out, std::size_t len) {
+#if BIQUAD_HAS_CMSIS
+        processBufferCmsis(in, out, len);
+#else
+        processBufferPortable(in, out, len);
+#endif
+    }
+
+    // DF2T with error feedback; uses sec[] states only
+    inline void processBufferPortable(const int32_t* in, int32_t* out, std::size_t len) {
+        if (!in || !out) {
+            return; // no-op if invalid
+        }
+        for (std::size_t i = 0; i < len; ++i) {
+            int32_t y = in[i];
+            for (auto &s : sec) y = s.process(y);
+            out[i] = y;
+        }
+    }
+
+#if BIQUAD_HAS_CMSIS
+    // The instance only points at the members, so it is rebuilt per call
+    // (four stores) rather than kept: the cascade stays safe to copy
+    inline void processBufferCmsis(const int32_t* in, int32_t* out, std::size_t len) {
+        if (!in || !out || len == 0) {
+            return; // no-op if invalid
+        }
+        arm_biquad_cas_df1_32x64_ins_q31 inst;
+        inst.numStages = (uint8_t)N;
+        inst.pState = df1.data();
+        inst.pCoeffs = df1_coeffs.data();
+        inst.postShift = 1;
+        arm_biquad_cas_df1_32x64_q31(&inst, const_cast<q31_t*>(in), out, (uint32_t)len);
+    }
+#endif
+
+    inline void reset() noexcept {
+        for (auto &s : sec) s.reset();
+#if BIQUAD_HAS_CMSIS
+        df1.fill(0);
+#endif
+    }
+
+    inline int32_t settle(int32_t x) noexcept {
+        for (std::size_t k = 0; k < N; ++k) {
+            const int32_t y = sec[k].settle(x);
+#if BIQUAD_HAS_CMSIS
+            df1[4 * k + 0] = x;
+            df1[4 * k + 1] = x;
+            df1[4 * k + 2] = (q63_t)y * (INT64_C(1) << 32);
+            df1[4 * k + 3] = df1[4 * k + 2];
+#endif
+            x = y;
+        }
+        return x;
+    }
+
+    // Move the input reference by dx (see BiquadQ31::rebase)
+    inline void rebase(int32_t dx) noexcept {
+        for (std::size_t k = 0; k < N; ++k) {
+            const int32_t y = sec[k].rebase(dx);
+#if BIQUAD_HAS_CMSIS
+            df1[4 * k + 0] -= dx;
+            df1[4 * k + 1] -= dx;
+            df1[4 * k + 2] -= (q63_t)y * (INT64_C(1) << 32);
+            df1[4 * k + 3] -= (q63_t)y * (INT64_C(1) << 32);
+#endif
+            dx = y;
+        }
+    }
+};
+
+// Q15 data in and out, Q31 states and arithmetic inside
+template <std::size_t N>
+struct BiquadCascadeQ15 {
+    static constexpr std::size_t CHUNK = 32;    // Q31 scratch per kernel call
+
+    BiquadCascadeQ31<N> q31{};
+
+    inline void setCoeffs(const BiquadCascadeDF2T<N>& f) noexcept { q31.setCoeffs(f); }
+
+    inline int16_t process(int16_t x) { return narrow(q31.process((int32_t)x * 65536)); }
+
+    // Widened a chunk at a time so the Q31 block kernel runs once per chunk
+    inline void processBuffer(const int16_t* in, int16_t* out, std::size_t len) {
+        if (!in || !out) {
+            return; // no-op if invalid
+        }
+        int32_t buf[CHUNK];
+        for (std::size_t off = 0; off < len; off += CHUNK) {
+            const std::size_t m = len - off < CHUNK ? len - off : CHUNK;
+            for (std::size_t i = 0; i < m; ++i) buf[i] = (int32_t)in[off + i] * 65536;
+            q31.processBuffer(buf, buf, m);
+            for (std::size_t i = 0; i < m; ++i) out[off + i] = narrow(buf[i]);
+        }
+    }
+
+    inline void reset() noexcept { q31.reset(); }
+
+    inline void settle(int16_t x) noexcept { q31.settle((int32_t)x * 65536); }
+
+    inline void rebase(int16_t dx) noexcept { q31.rebase((int32_t)dx * 65536); }
+
+private:
+    static inline int16_t narrow(int32_t y) noexcept {
+        const int32_t r = (int32_t)((y + INT64_C(0x8000)) >> 16);
+        return (int16_t)(r > INT16_MAX ? INT16_MAX : r);
+    }
+};
+
+#endif /* BIQUAD_FIXED_H */
@@ -0,0 +1,86 @@
+#ifndef DC_AVERAGE_H
+#define DC_AVERAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Cheapest heart-rate band-pass: a one-pole DC blocker for the high-pass
+// edge and a moving average for the low-pass one.
+//
+//   d(n) = x(n) - x(n-1) + pole * d(n-1)
+//   y(n) = (d(n) + ... + d(n-len+1)) * (1 + pole) / (2 * len)
+//
+// The blocker's gain (1 + pole) / 2 rides on the average's scale. The sum
+// of the last len blocker outputs telescopes,
+//
+//   S(n) = x(n) - x(n-len) + pole * S(n-1)
+//
+// so the kernel keeps a ring of the last len inputs and no blocker state.
+// Unlike a plain running sum, rounding in S decays with the pole instead of
+// accumulating, so nothing needs re-summing. The difference of two raw
+// counts is exact, so a constant input level cancels out of S.
+// Coefficients come from the hr_filter tables.
+struct DcBlockAverage {
+    // 0.443 fs / len at 7 Hz: len 203 at 3200 Hz, the fastest table rate
+    static constexpr std::size_t MAX_LEN = 204;
+
+    // Per-sample cost of processBlock(): 2 mul, 2 add, and 4 memory
+    // accesses (input, ring read and write, output)
+    static constexpr std::size_t MUL = 2, ADD = 2, MEM = 4;
+
+    float pole = 0.0f;
+    float scale = 1.0f;         // blocker gain (1 + pole) / 2 over len
+    uint8_t len = 1;
+
+    float ring[MAX_LEN]{};      // x(n-len) .. x(n-1), oldest at pos
+    float sum = 0.0f;           // S(n-1)
+    uint8_t pos = 0;
+
+    inline void setCoeffs(float p, uint8_t n) noexcept {
+        pole = p;
+        len = n < 1 ? 1 : (n > MAX_LEN ? (uint8_t)MAX_LEN : n);
+        scale = 0.5f * (1.0f + p) / (float)len;
+        reset();
+    }
+
+    inline void reset() noexcept {
+        for (auto &v : ring) v = 0.0f;
+        sum = 0.0f;
+        pos = 0;
+    }
+
+    // Steady state for a constant input x: the blocker output is 0
+    inline void settle(float x) noexcept {
+        for (std::size_t k = 0; k < len; ++k) ring[k] = x;
+        sum = 0.0f;
+        pos = 0;
+    }
+
+    // Strided like BiquadCascadeDF2T::processBlock; in == out is allowed
+    inline void processBlock(const float* in, std::size_t in_stride,
+                             float* out, std::size_t out_stride, std::size_t n) noexcept {
+        if (!in || !out) {
+            return; // no-op if invalid
+        }
+        float s = sum;
+        std::size_t i = 0;
+        while (i < n) {
+            // Up to the ring's wrap without a per-sample branch
+            const std::size_t end = i + (n - i < (std::size_t)(len - pos) ? n - i : len - pos);
+            const std::size_t base = (std::size_t)pos - i;   // wraps, ring[base + i] does not
+            for (; i < end; ++i) {
+                const float x = in[i * in_stride];
+                s = (x - ring[base + i]) + pole * s;
+                ring[base + i] = x;
+                out[i * out_stride] = s * scale;
+            }
+            pos = (uint8_t)(base + end);
+            if (pos == len) {
+                pos = 0;
+            }
+        }
+        sum = s;
+    }
+};
+
+#endif /* DC_AVERAGE_H */
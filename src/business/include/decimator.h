@@ -0,0 +1,119 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// Polyphase FIR decimator between the oversampled PPG and the HR pipeline.
+//
+// The anti-alias filter has P = TapsPerPhase taps per phase, i.e. P*M taps
+// for factor M. Only every M-th output is computed, so each input sample
+// costs P MACs regardless of M, and the stages behind it run M times less
+// often while keeping the SNR gained by oversampling.
+//
+// The factor is chosen at runtime (2..MaxFactor); coefficients are designed
+// once in init() (Blackman-windowed sinc, unity DC gain). Memory is fixed:
+// P*MaxFactor coefficients and a 2*P*MaxFactor mirrored delay line.
+template <std::size_t TapsPerPhase = 8, std::size_t MaxFactor = 32>
+class PolyphaseDecimator {
+public:
+    static_assert(TapsPerPhase >= 2, "need at least 2 taps per phase");
+    static_assert(MaxFactor >= 2, "decimation factor must allow >= 2");
+
+    static constexpr std::size_t MAX_TAPS = TapsPerPhase * MaxFactor;
+
+    // Cutoff as a fraction of the output rate. With 8 taps per phase the
+    // Blackman transition band is about 0.7 fs_out wide around it, so a
+    // quarter of fs_out leaves 7 Hz at 0.84 gain at 50 Hz out but at 0.42
+    // at 25 Hz out.
+    static constexpr float CUTOFF_OF_OUTPUT_RATE = 0.25f;
+    // Given the output rate, the cutoff is raised to at least
+    // MIN_CUTOFF_HZ (7 Hz back to 0.84 at 25 Hz out), up to
+    // MAX_CUTOFF_OF_OUTPUT_RATE so that fs_out - 7 Hz, which folds onto the
+    // band edge, stays in the stop band.
+    static constexpr float MIN_CUTOFF_HZ = 10.0f;
+    static constexpr float MAX_CUTOFF_OF_OUTPUT_RATE = 0.4f;
+
+    // fs_out_hz = 0 keeps the cutoff at CUTOFF_OF_OUTPUT_RATE
+    bool init(uint32_t factor, uint32_t fs_out_hz = 0) {
+        if (factor < 2 || factor > MaxFactor) {
+            return false;
+        }
+        m = factor;
+        taps = TapsPerPhase * factor;
+
+        float cutoff = CUTOFF_OF_OUTPUT_RATE;  // of the output rate
+        if (fs_out_hz > 0) {
+            const float min_cutoff = MIN_CUTOFF_HZ / (float)fs_out_hz;
+            if (cutoff < min_cutoff) cutoff = min_cutoff;
+            if (cutoff > MAX_CUTOFF_OF_OUTPUT_RATE) cutoff = MAX_CUTOFF_OF_OUTPUT_RATE;
+        }
+
+        const float pi = 3.14159265358979323846f;
+        const float fc = cutoff / (float)factor; // cycles/input sample
+        const float mid = 0.5f * (float)(taps - 1);
+        float sum = 0.0f;
+        for (std::size_t i = 0; i < taps; ++i) {
+            const float t = (float)i - mid;
+            const float sinc = (t == 0.0f) ? 2.0f * fc : std::sin(2.0f * pi * fc * t) / (pi * t);
+            const float w = 0.42f - 0.5f * std::cos(2.0f * pi * (float)i / (float)(taps - 1))
+                          + 0.08f * std::cos(4.0f * pi * (float)i / (float)(taps - 1));
+            h[i] = sinc * w;
+            sum += h[i];
+        }
+        for (std::size_t i = 0; i < taps; ++i) h[i] /= sum;
+
+        reset();
+        return true;
+    }
+
+    void reset() {
+        for (auto &v : line) v = 0.0f;
+        pos = 0;
+        phase = 0;
+    }
+
+    // Prefill the delay line with a constant (e.g. the first raw sample) so
+    // the PPG DC offset does not produce a start-up ramp
+    void settle(float x) {
+        for (std::size_t i = 0; i < 2 * taps; ++i) line[i] = x;
+    }
+
+    uint32_t factor() const { return m; }
+
+    // Consume n input samples; writes one output per M inputs to out and
+    // returns how many were written (at most n / M + 1). in and out may alias.
+    std::size_t process(const float* in, std::size_t n, float* out) {
+        if (!in || !out || taps == 0) {
+            return 0;
+        }
+        std::size_t produced = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            // Mirrored delay line: the newest `taps` samples are always
+            // contiguous at line[pos .. pos + taps - 1], newest last
+            line[pos] = in[i];
+            line[pos + taps] = in[i];
+            pos = (pos + 1 == taps) ? 0 : pos + 1;
+
+            if (++phase == m) {
+                phase = 0;
+                const float* x = &line[pos];
+                float acc = 0.0f;
+                for (std::size_t k = 0; k < taps; ++k) acc += h[k] * x[k];
+                out[produced++] = acc;
+            }
+        }
+        return produced;
+    }
+
+private:
+    float h[MAX_TAPS]{};
+    float line[2 * MAX_TAPS]{};
+    std::size_t taps = 0;
+    std::size_t pos = 0;
+    uint32_t m = 0;
+    uint32_t phase = 0;
+};
+
+#endif /* DECIMATOR_H */
@@ -5,6 +5,7 @@
 #define HEART_RATE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "hal_sensor.h"
 
 #ifdef __cplusplus
@@ -15,18 +16,184 @@ typedef enum {
     HR_STATE_IDLE = 0,
     HR_STATE_RUNNING,
     HR_STATE_NO_CONTACT,
-    HR_STATE_ERROR
+    HR_STATE_ERROR,
+    HR_STATE_MOTION         /* activity gate suspended the estimates */
 } hr_state_t;
 
+/* How much of the pipeline runs, chosen by the activity gate */
+typedef enum {
+    HR_MODE_FULL = 0,       /* all estimators */
+    HR_MODE_REDUCED,        /* spectral estimate only */
+    HR_MODE_SUSPENDED,      /* nothing, state reports HR_STATE_MOTION */
+    HR_MODE_COUNT
+} hr_mode_t;
+
+/* PPG band-pass profiles, costliest first; the cheaper ones let more
+ * baseline wander and out-of-band noise through */
+typedef enum {
+    HR_FILTER_PROFILE_FULL = 0,     /* 4th-order HP + 2nd-order LP, three biquads */
+    HR_FILTER_PROFILE_BIQUAD,       /* one band-pass biquad */
+    HR_FILTER_PROFILE_DC_AVERAGE,   /* DC blocker + moving average */
+    HR_FILTER_PROFILE_COUNT
+} hr_filter_profile_t;
+
+/* Time and processing cycles spent per mode since start */
+typedef struct {
+    uint32_t time_ms[HR_MODE_COUNT];
+    uint64_t cycles[HR_MODE_COUNT];
+} hr_mode_stats_t;
+
+/* Time-domain HRV over the last CONFIG_HR_HRV_WINDOW_S of beats */
+typedef struct {
+    float rmssd_ms;
+    float sdnn_ms;
+    float pnn50_pct;
+    uint16_t intervals;     /* RR intervals in the window */
+} hr_hrv_t;
+
+/* Rhythm irregularity over the last CONFIG_HR_RHYTHM_BEATS RR intervals */
+typedef struct {
+    float nrmssd;           /* RMSSD / mean RR */
+    float sd1_sd2;          /* Poincare dispersion ratio */
+    float sample_entropy;   /* m = 1, r = 30 ms */
+    uint8_t votes;          /* indices beyond their AF-typical limit, 0..3 */
+    bool irregular;         /* AF-like rhythm: screen, not a diagnosis */
+    uint16_t intervals;
+} hr_rhythm_t;
+
+/* Called from the HR thread when the irregular flag changes */
+typedef void (*hr_rhythm_cb_t)(const hr_rhythm_t *rhythm);
+
+/* Latest HR and SpO2, as published once per HR block */
+typedef struct {
+    float bpm;
+    float spo2;             /* % */
+    bool bpm_valid;
+    bool spo2_valid;        /* always false without CONFIG_MAX30102_SPO2_MODE */
+} hr_vitals_t;
+
+/* Called from the HR thread after each block */
+typedef void (*hr_vitals_cb_t)(const hr_vitals_t *vitals);
+
+/* Vitals the alert rules can watch */
+typedef enum {
+    HR_VITAL_HR = 0,        /* tracked BPM */
+    HR_VITAL_SPO2,          /* % */
+    HR_VITAL_RESP,          /* breaths/min */
+    HR_VITAL_COUNT
+} hr_vital_t;
+
+#define HR_ALERT_BELOW      0x01    /* alert below the threshold, not above */
+#define HR_ALERT_SAMPLES    0x02    /* duration counts readings, not seconds */
+
+/* "vital above (below) threshold for duration" alert rule, values in tenths
+ * of the vital's unit. Also the BLE wire format: 8 bytes, little-endian */
+typedef struct {
+    uint8_t id;             /* reported with the alert, 0 = empty slot */
+    uint8_t vital;          /* hr_vital_t */
+    uint8_t flags;          /* HR_ALERT_* */
+    uint8_t duration;       /* seconds, or readings with HR_ALERT_SAMPLES */
+    int16_t threshold;
+    uint16_t hysteresis;    /* released once past the threshold by this much */
+} hr_alert_rule_t;
+
+/* A raised alert */
+typedef struct {
+    uint8_t rule_id;
+    uint8_t vital;
+    int16_t value;          /* tenths, the reading that raised it */
+} hr_alert_t;
+
+/* Called from the HR thread for each raised alert */
+typedef void (*hr_alert_cb_t)(const hr_alert_t *alert);
+
+/* Newest beat against the ensemble-averaged beat template, and the
+ * template's shape features (band-passed PPG) */
+typedef struct {
+    float correlation;      /* -1..1 */
+    bool good_beat;         /* correlation high enough to trust the beat */
+    float rise_time_ms;     /* foot to systolic peak */
+    float notch_ms;         /* systolic peak to dicrotic notch, 0 if none */
+} hr_morphology_t;
+
 /* Start background processing thread for the given heart-rate sensor */
 bool heart_rate_start(hal_sensor_t *hr_sensor);
 
-/* Get the latest BPM value (returns true if valid) */
+/* Accelerometer used as the motion-artifact reference (CONFIG_HR_MOTION_CANCEL)
+ * and the activity gate input (CONFIG_HR_ACTIVITY_GATE). Call before heart_rate_start(); returns false if not supported */
+bool heart_rate_set_motion_sensor(hal_sensor_t *accel);
+
+/* Get the latest tracked BPM value (returns true if valid) */
 bool heart_rate_get_bpm(float *bpm_out);
 
+/* Tracked BPM plus its variance in BPM^2 (variance_out may be NULL) */
+bool heart_rate_get_estimate(float *bpm_out, float *variance_out);
+
+/* Latest HRV metrics (returns true once enough successive beats are in
+ * the window) */
+bool heart_rate_get_hrv(hr_hrv_t *hrv_out);
+
+/* Latest rhythm-irregularity screening (returns true once the window holds
+ * enough successive intervals) */
+bool heart_rate_get_rhythm(hr_rhythm_t *rhythm_out);
+
+/* Rhythm callback (NULL to remove), called from the HR thread */
+void heart_rate_set_rhythm_callback(hr_rhythm_cb_t cb);
+
+/* Latest beat score and morphology (returns true once the template has
+ * formed and a beat was scored against it) */
+bool heart_rate_get_morphology(hr_morphology_t *shape_out);
+
+/* Respiratory rate in breaths/min from the PPG baseline, beat amplitude
+ * and RR modulation (returns true if valid) */
+bool heart_rate_get_respiration(float *brpm_out);
+
+/* Latest SpO2 in % (returns true if valid). Needs CONFIG_MAX30102_SPO2_MODE;
+ * heart_rate_start() then also registers it as the HAL_SENSOR_TYPE_SPO2
+ * logical sensor */
+bool heart_rate_get_spo2(float *spo2_out);
+
+/* Vitals callback (NULL to remove), called from the HR thread once per
+ * block with the latest estimates */
+void heart_rate_set_vitals_callback(hr_vitals_cb_t cb);
+
 /* Optional: get current processing state */
 hr_state_t heart_rate_get_state(void);
 
+/* Current activity-gated processing mode */
+hr_mode_t heart_rate_get_mode(void);
+
+/* Per-mode time split (returns false if stats_out is NULL) */
+bool heart_rate_get_mode_stats(hr_mode_stats_t *stats_out);
+
+/* Band-pass profile for the PPG channels and the motion reference, from any
+ * thread; takes effect with the next block. Returns false if unknown */
+bool heart_rate_set_filter_profile(hr_filter_profile_t profile);
+
+/* Profile last set (HR_FILTER_PROFILE_FULL at start) */
+hr_filter_profile_t heart_rate_get_filter_profile(void);
+
+/* Replace the alert rule in slot (NULL or an id of 0 empties it), from any
+ * thread; the slot's pending state and latched alert start over. Returns
+ * false for a bad slot, vital or flag. A default table is loaded at start */
+bool heart_rate_set_alert_rule(uint8_t slot, const hr_alert_rule_t *rule);
+
+/* Rule in slot (returns false for a bad slot or NULL rule_out) */
+bool heart_rate_get_alert_rule(uint8_t slot, hr_alert_rule_t *rule_out);
+
+/* Rule slots, CONFIG_HR_ALERT_RULES */
+uint8_t heart_rate_alert_rule_count(void);
+
+/* Slots whose alert was raised and not yet cleared, one bit per slot */
+uint32_t heart_rate_get_alerts(void);
+
+/* Acknowledge the raised alerts; a rule still holding stays quiet until
+ * its vital is back past the hysteresis */
+void heart_rate_clear_alerts(void);
+
+/* Alert callback (NULL to remove), called from the HR thread */
+void heart_rate_set_alert_callback(hr_alert_cb_t cb);
+
 #ifdef __cplusplus
 }
 #endif
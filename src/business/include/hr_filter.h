@@ -2,50 +2,192 @@
 #define HR_FILTER_H
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
+#include <atomic>
 #include <stdexcept>
 
-struct BiquadDF2T
-{
-    // Direct form II
-    // y[n] = a0*x[n] + a1*x[n-1] + a2*x[n-2] – b1*y[n-1] – b2*y[n-2]
-    float b0=0, b1=0, b2=0, a1=0, a2=0;
-    float s1=0, s2=0; // two delay states (transposed)
-
-    inline float process(float x) {
-        float y = b0 * x + s1;
-        s1 = b1 * x - a1 * y + s2;
-        s2 = b2 * x - a2 * y;
-        return y;
-    }
-    inline void reset() noexcept { s1 = 0.0f; s2 = 0.0f; }
+#include "biquad.h"
+#include "biquad_fixed.h"
+#include "dc_average.h"
+
+// Default sample rate of the heart-rate band-pass (MAX30102 DT default)
+constexpr uint32_t HR_FILTER_DEFAULT_RATE_HZ = 100;
+
+// Load the heart-rate band-pass coefficients for sample rate fs_hz into a
+// cascade (states cleared). Returns false if no table exists for fs_hz.
+bool hr_filter_load(BiquadCascadeDF2T<3>& c, uint32_t fs_hz = HR_FILTER_DEFAULT_RATE_HZ);
+
+// Largest decimation factor in [2, max_factor] that takes sensor rate fs_hz
+// to a band-pass rate with a table, at or above target_hz. Returns 1 if the
+// filter should run at fs_hz directly.
+uint32_t hr_filter_decimation(uint32_t fs_hz, uint32_t target_hz, uint32_t max_factor);
+
+// Band-pass profiles over the same 0.4-7 Hz edges, costliest first. They
+// differ in roll-off, i.e. in how much baseline wander and out-of-band
+// noise reach the estimators:
+//  - Full:      4th-order Butterworth HP + 2nd-order LP (three biquads)
+//  - Biquad:    one 2nd-order band-pass section
+//  - DcAverage: one-pole DC blocker + moving average (DcBlockAverage)
+enum class HrFilterProfile : uint8_t {
+    Full = 0,
+    Biquad,
+    DcAverage,
+    Count
+};
+
+// Per-sample cost of a profile's float kernel, taken from the kernels'
+// own counts. Memory accesses count alongside arithmetic: the moving
+// average's ring costs as much as its multiplies. Fixed-point builds only
+// make Full and Biquad dearer (DcAverage stays float), so the order holds.
+struct HrFilterCost {
+    uint8_t mul;
+    uint8_t add;
+    uint8_t mem;            // loads and stores
+
+    constexpr uint32_t ops() const { return (uint32_t)mul + add + mem; }
+};
+
+template <typename Kernel>
+constexpr HrFilterCost hr_filter_kernel_cost() {
+    return { (uint8_t)Kernel::MUL, (uint8_t)Kernel::ADD, (uint8_t)Kernel::MEM };
+}
+
+constexpr HrFilterCost hr_filter_cost(HrFilterProfile p) {
+    return p == HrFilterProfile::Full   ? hr_filter_kernel_cost<BiquadCascadeDF2T<3>>()
+         : p == HrFilterProfile::Biquad ? hr_filter_kernel_cost<BiquadCascadeDF2T<1>>()
+         :                                hr_filter_kernel_cost<DcBlockAverage>();
+}
+
+// One heart-rate band-pass stream (Red, IR, motion reference, ...).
+// Instances share nothing but the constant coefficient tables, so separate
+// channels can be filtered from separate threads without locking. An
+// instance itself is single-producer: process(), reset(), save() and
+// restore() belong to the owning thread; setSampleRate() may be called from
+// any thread.
+//
+// The arithmetic (float, Q31 or Q15) is selected by CONFIG_HR_FILTER_*.
+// Samples are float in and out either way; only the cascade is integer.
+// Fixed-point builds quantize the input less a tracked DC level, mapping
+// +/-CONFIG_HR_FILTER_FULL_SCALE around it to +/-1.0, so the fixed-point
+// range covers the pulse and not the ADC range. The level is re-anchored
+// at block starts; the band-pass has no DC gain, so that is exact. A jump
+// beyond full scale cannot be represented: the filter settles on it (an
+// unsettled filter settles on its first input). The DcAverage profile runs
+// in float in every build.
+class HrFilter {
+public:
+#if defined(CONFIG_HR_FILTER_Q31)
+    using Cascade = BiquadCascadeQ31<3>;
+    using Section = BiquadCascadeQ31<1>;
+#elif defined(CONFIG_HR_FILTER_Q15)
+    using Cascade = BiquadCascadeQ15<3>;
+    using Section = BiquadCascadeQ15<1>;
+#else
+    using Cascade = BiquadCascadeDF2T<3>;
+    using Section = BiquadCascadeDF2T<1>;
+#endif
+
+    // Complete filter state; plain data, safe to copy and store
+    struct State {
+        Cascade cascade{};
+        Section section{};
+        DcBlockAverage average{};
+        float last_in = 0.0f;
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+        float offset = 0.0f;        // input level quantized as 0
+        bool anchored = false;      // offset set by settle() or a block
+#endif
+        int table = -1;
+        HrFilterProfile profile = HrFilterProfile::Full;
+    };
+
+    HrFilter() { init(); }
+    HrFilter(const HrFilter&) = delete;
+    HrFilter& operator=(const HrFilter&) = delete;
+
+    // Load the table for fs_hz and clear the state
+    bool init(uint32_t fs_hz = HR_FILTER_DEFAULT_RATE_HZ);
+
+    // Load the table for fs_hz and start from the steady state for a constant
+    // input `initial` (pass the first raw sample). The PPG DC offset then
+    // produces no high-pass transient and the output is usable within a
+    // second instead of after 10-20 s of ringing.
+    bool init(uint32_t fs_hz, float initial);
+
+    // Switch to the coefficient table for fs_hz. Takes effect at the start of
+    // the next process() call; the states are re-settled on the last input so
+    // the DC offset does not ring through the new sections.
+    // Returns false (and keeps the current table) for unsupported rates.
+    bool setSampleRate(uint32_t fs_hz);
+
+    // Rate of the active table (pending switches not yet applied)
+    uint32_t sampleRate() const;
+
+    // Switch the profile, from any thread. Like a rate switch it takes
+    // effect at the start of the next process() call, re-settled on the
+    // last input; init() keeps the profile.
+    void setProfile(HrFilterProfile p);
+
+    // Active profile (pending switches not yet applied)
+    HrFilterProfile profile() const { return st.profile; }
+
+    void process(const float* in, float* out, std::size_t n) { process(in, 1, out, 1, n); }
+
+    // Strided form: reads in[i*in_stride], writes out[i*out_stride]. Filters
+    // one channel of an interleaved frame buffer in place without a copy.
+    void process(const float* in, std::size_t in_stride,
+                 float* out, std::size_t out_stride, std::size_t n);
+
+    // Clear the delay line, keep the rate
+    void reset();
+
+    // Preload the steady state for a constant input x, keep the rate (finger
+    // placement, sensor re-init); as scipy's lfilter_zi scaled by x
+    void settle(float x);
+
+    void save(State& out) const { out = st; }
+    void restore(const State& in) { st = in; }
+
+private:
+    State st{};
+    std::atomic<int> pending{-1};
+    std::atomic<int> pending_profile{-1};
 };
 
-template <std::size_t N>
-struct BiquadCascadeDF2T {
-    std::array<BiquadDF2T, N> sec{};
+// Statically sized set of independent filters, one per channel
+template <std::size_t K>
+class HrFilterBank {
+public:
+    bool init(uint32_t fs_hz = HR_FILTER_DEFAULT_RATE_HZ) {
+        bool ok = true;
+        for (auto &f : ch) ok = f.init(fs_hz) && ok;
+        return ok;
+    }
 
-    inline float process(float x) {
-        for (auto &s : sec) x = s.process(x);
-        return x;
+    bool setSampleRate(uint32_t fs_hz) {
+        bool ok = true;
+        for (auto &f : ch) ok = f.setSampleRate(fs_hz) && ok;
+        return ok;
     }
 
-    inline void processBuffer(const float* in, float* out, std::size_t len) {
-        if (!in || !out) {
-            return; // no-op if invalid
-        }
-        for (std::size_t i = 0; i < len; ++i) {
-            float y = in[i];
-            for (auto &s : sec) y = s.process(y);
-            out[i] = y;
-        }
+    void setProfile(HrFilterProfile p) {
+        for (auto &f : ch) f.setProfile(p);
     }
 
-    inline void reset() noexcept { for (auto &s : sec) s.reset(); }
+    static constexpr std::size_t size() { return K; }
+    HrFilter& operator[](std::size_t i) { return ch[i]; }
+    const HrFilter& operator[](std::size_t i) const { return ch[i]; }
+
+private:
+    std::array<HrFilter, K> ch;
 };
 
-// API to initialize and run the bandpass cascade
+// Single-stream API kept for existing callers; runs a default instance
 void hr_filter_init();
+void hr_filter_init(float initial);
 void hr_filter_process(const float* in, float* out, std::size_t n);
+bool hr_filter_set_sample_rate(uint32_t fs_hz);
+void hr_filter_set_profile(HrFilterProfile p);
 
-#endif /* HR_FILTER_H */
\ No newline at end of file
+#endif /* HR_FILTER_H */
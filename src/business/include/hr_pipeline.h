@@ -0,0 +1,171 @@
+#ifndef HR_PIPELINE_H
+#define HR_PIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pipeline.h"
+#include "hal_hampel.h"
+#include "decimator.h"
+#include "hr_filter.h"
+#include "beat_detector.h"
+#include "spectral_hr.h"
+#include "autocorr_hr.h"
+#include "motion_canceller.h"
+
+// Pipeline stages over the heart-rate classes. Each adapter owns its
+// component as a public member, so callers reach the detector's RR ring or
+// the estimators' results through Pipeline::stage<I>().
+
+// Hampel spike filter on raw samples (window / 2 samples of delay). The
+// MAX30102 HAL already runs it with CONFIG_MAX30102_SPIKE_FILTER; this is
+// for sources that do not.
+template <uint8_t Window = 7>
+struct SpikeStage {
+    hal_hampel_t hampel{};
+    float n_sigma = 3.0f;
+    float min_dev = 16.0f;          // raw counts
+
+    bool init(PipelineRate&) {
+        hal_hampel_init(&hampel, Window, n_sigma, min_dev);
+        return true;
+    }
+    void reset() { hal_hampel_reset(&hampel); }
+    void settle(float) {}
+    std::size_t process(float* x, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) hal_hampel_update(&hampel, &x[i]);
+        return n;
+    }
+};
+
+// Polyphase decimation from the sensor rate to the largest band-pass rate
+// at or above the target; a pass-through when the sensor already runs there
+template <std::size_t TapsPerPhase = 8, std::size_t MaxFactor = 32>
+struct DecimateStage {
+    PolyphaseDecimator<TapsPerPhase, MaxFactor> decimator;
+    uint32_t m = 1;
+
+    bool init(PipelineRate& rate) {
+        m = hr_filter_decimation(rate.hz, rate.target_hz, (uint32_t)MaxFactor);
+        if (m > 1 && !decimator.init(m, rate.hz / m)) {
+            return false;
+        }
+        rate.hz /= m;
+        return true;
+    }
+    void reset() { decimator.reset(); }
+    void settle(float x) {
+        if (m > 1) decimator.settle(x);
+    }
+    std::size_t process(float* x, std::size_t n) {
+        return m > 1 ? decimator.process(x, n, x) : n;
+    }
+    uint32_t factor() const { return m; }
+};
+
+// Heart-rate band-pass; the profile is set on the filter member
+struct BandPassStage {
+    HrFilter filter;
+
+    bool init(PipelineRate& rate) { return filter.init(rate.hz); }
+    void reset() { filter.reset(); }
+    void settle(float x) { filter.settle(x); }
+    std::size_t process(float* x, std::size_t n) {
+        filter.process(x, x, n);
+        return n;
+    }
+};
+
+// NLMS motion cancelling against n interleaved x/y/z reference frames set
+// with reference() before each run; without one the block passes unchanged
+template <std::size_t Taps>
+struct CancelStage {
+    MotionCanceller<Taps> canceller;
+    const float* ref = nullptr;
+
+    bool init(PipelineRate&) {
+        canceller.init();
+        return true;
+    }
+    void reset() { canceller.reset(); }
+    void settle(float) {}
+    void reference(const float* frames) { ref = frames; }
+    std::size_t process(float* x, std::size_t n) {
+        if (ref) {
+            canceller.process(x, ref, n);
+            ref = nullptr;
+        }
+        return n;
+    }
+};
+
+struct DetectStage {
+    BeatDetector detector;
+
+    bool init(PipelineRate& rate) {
+        detector.init(rate.hz);
+        return true;
+    }
+    void reset() { detector.reset(); }
+    void settle(float) {}
+    std::size_t process(float* x, std::size_t n) {
+        detector.process(x, n);
+        return n;
+    }
+};
+
+struct SpectralStage {
+    SpectralHr spectral;
+
+    bool init(PipelineRate& rate) { return spectral.init(rate.hz); }
+    void reset() { spectral.reset(); }
+    void settle(float) {}
+    std::size_t process(float* x, std::size_t n) {
+        spectral.process(x, n);
+        return n;
+    }
+};
+
+struct AutocorrStage {
+    AutocorrHr autocorr;
+
+    bool init(PipelineRate& rate) { return autocorr.init(rate.hz); }
+    void reset() { autocorr.reset(); }
+    void settle(float) {}
+    std::size_t process(float* x, std::size_t n) {
+        autocorr.process(x, n);
+        return n;
+    }
+};
+
+// Variants, Block raw samples per run.
+//
+// Front end: one PPG channel down to the band-passed signal. This is what
+// the firmware runs, on Red and (in SpO2 mode) on IR; the detector, the
+// estimators, motion cancelling and Spo2Estimator are wired by hand in
+// heart_rate.cpp, since the activity gate decides per block which of them
+// run.
+template <std::size_t Block>
+using HrFrontEnd = Pipeline<Block, DecimateStage<>, BandPassStage>;
+
+// HR only: the front end, the beat detector and both estimators chained
+// as stages. Exercised by the tests, not the shipped wiring.
+template <std::size_t Block>
+using HrOnlyPipeline = Pipeline<Block, DecimateStage<>, BandPassStage, DetectStage,
+                                SpectralStage, AutocorrStage>;
+
+// IR channel in SpO2 mode: a front end of its own, run on the same block
+// lengths as Red. The ratio of ratios needs both channels, so
+// Spo2Estimator stays with the caller (DC from the decimated blocks,
+// run<0, 1>(), AC from the band-passed ones).
+template <std::size_t Block>
+using Spo2IrPipeline = HrFrontEnd<Block>;
+
+// With motion cancelling: NLMS right behind the band-pass, ahead of
+// everything that looks for beats. Exercised by the tests, not the shipped
+// wiring.
+template <std::size_t Block, std::size_t Taps>
+using HrMotionPipeline = Pipeline<Block, DecimateStage<>, BandPassStage, CancelStage<Taps>,
+                                  DetectStage, SpectralStage, AutocorrStage>;
+
+#endif /* HR_PIPELINE_H */
@@ -0,0 +1,62 @@
+#ifndef HR_TRACKER_H
+#define HR_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// One per-window BPM estimate and how much to trust it (0..1)
+struct HrCandidate {
+    float bpm;
+    float confidence;
+};
+
+// Constant-velocity Kalman tracker over [BPM, BPM/s] that fuses any number
+// of per-window candidates (peaks, spectral, autocorrelation, ...).
+//
+// Each candidate is a scalar measurement with variance R_BASE / conf^2.
+// Candidates outside the GATE-sigma innovation window or further than
+// MAX_JUMP_BPM from the prediction are rejected as physiologically
+// impossible. If confident candidates keep disagreeing with the track for
+// REACQUIRE_S the track restarts on them (real step, or a wrong first lock).
+// The estimate is reported valid while its variance stays below VALID_VAR,
+// so gaps in the input let it expire instead of freezing a stale value.
+class HrTracker {
+public:
+    static constexpr float BPM_MIN = 30.0f;
+    static constexpr float BPM_MAX = 220.0f;
+    static constexpr float R_BASE = 4.0f;          // BPM^2 at confidence 1
+    static constexpr float Q_ACCEL = 0.5f;         // BPM^2/s^3 process noise
+    static constexpr float MAX_SLEW = 5.0f;        // BPM/s
+    static constexpr float MAX_JUMP_BPM = 30.0f;
+    static constexpr float GATE = 3.0f;            // sigmas
+    static constexpr float MIN_CONF = 0.1f;        // ignored below
+    static constexpr float INIT_CONF = 0.3f;       // needed to start a track
+    static constexpr float REACQUIRE_S = 8.0f;
+    static constexpr float VALID_VAR = 16.0f;      // BPM^2 (4 BPM sigma)
+
+    HrTracker() { reset(); }
+
+    void reset();
+
+    // Advance the track by dt_s seconds and fuse n candidates (n may be 0).
+    // Returns the number of candidates accepted.
+    std::size_t update(float dt_s, const HrCandidate* c, std::size_t n);
+
+    bool valid() const { return active && p00 <= VALID_VAR; }
+    bool tracking() const { return active; }
+    float bpm() const { return h; }
+    float slope() const { return v; }
+    float variance() const { return p00; }
+
+private:
+    void predict(float dt);
+    bool correct(float z, float r);
+    void start(float z, float r);
+
+    bool active = false;
+    float h = 0.0f, v = 0.0f;                 // BPM, BPM/s
+    float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f; // covariance
+    float disagree_s = 0.0f;                  // time of confident rejections
+};
+
+#endif /* HR_TRACKER_H */
@@ -0,0 +1,187 @@
+#ifndef HRV_WINDOW_H
+#define HRV_WINDOW_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Time-domain HRV over a sliding window of RR intervals, O(1) per interval
+// and per query: the intervals sit in a fixed ring and the metrics come from
+// integer running sums that are updated on add and on eviction, never by a
+// rescan.
+//
+//   SDNN  = sqrt((N*sum(rr^2) - sum(rr)^2) / (N*(N-1)))
+//   RMSSD = sqrt(sum(d^2) / Nd)        d = successive difference
+//   pNN50 = 100 * #(|d| > 50 ms) / Nd
+//
+// The window holds at most window_ms of intervals (5 min is the short-term
+// standard) and at most Capacity of them. Each slot keeps the difference to
+// its predecessor, or none if the two were not successive beats (gap,
+// detector restart, rejected interval); the oldest interval never has one,
+// so a pair leaves the sums with its first interval. An interval that
+// differs from its predecessor by more than ECTOPIC_FRACTION is dropped as
+// ectopic or a missed beat and breaks the succession; the next interval is
+// checked against the last accepted one. Two successive rejected intervals
+// within ECTOPIC_FRACTION of each other mean the rhythm itself stepped
+// (exercise onset, detector recovering from missed beats): the second one
+// is accepted, unpaired, and later intervals are checked against it.
+template <std::size_t Capacity>
+class HrvWindow {
+public:
+    static_assert(Capacity >= 2, "need at least two intervals");
+
+    static constexpr uint16_t RR_MIN_MS = 250;
+    static constexpr uint16_t RR_MAX_MS = 2000;
+    static constexpr float ECTOPIC_FRACTION = 0.2f;
+    static constexpr uint16_t NN50_MS = 50;
+    static constexpr std::size_t MIN_PAIRS = 10;
+
+    struct Metrics {
+        float rmssd_ms;
+        float sdnn_ms;
+        float pnn50_pct;
+        float mean_rr_ms;
+        uint16_t intervals;     // N
+        uint16_t pairs;         // Nd
+    };
+
+    HrvWindow() { init(300000); }
+
+    // Start over with a window of window_ms of RR intervals
+    void init(uint32_t window_ms) {
+        span = window_ms;
+        reset();
+    }
+
+    // Drop all intervals, keep the window length
+    void reset() {
+        head = 0;
+        count = 0;
+        sum = 0;
+        sum_sq = 0;
+        diff_sq = 0;
+        pairs = 0;
+        nn50 = 0;
+        have_prev = false;
+        linked = false;
+        rejected = 0;
+    }
+
+    // One RR interval in ms; successive is false if it does not directly
+    // follow the previous one passed in
+    void add(uint16_t rr_ms, bool successive) {
+        if (rr_ms < RR_MIN_MS || rr_ms > RR_MAX_MS) {
+            linked = false;
+            rejected = 0;
+            return;
+        }
+        const int32_t d = (int32_t)rr_ms - (int32_t)prev;
+        if (successive && have_prev && !agrees(rr_ms, prev)) {
+            const bool stepped = rejected != 0 && agrees(rr_ms, rejected);
+            linked = false;
+            rejected = stepped ? 0 : rr_ms;
+            if (!stepped) {
+                return;
+            }
+        } else {
+            rejected = 0;
+        }
+        const bool paired = successive && linked;
+        prev = rr_ms;
+        have_prev = true;
+        linked = true;
+
+        if (count == Capacity) {
+            evict();
+        }
+        const std::size_t slot = (head + count) % Capacity;
+        rr[slot] = rr_ms;
+        diff[slot] = (int16_t)(paired && count ? d : NO_DIFF);
+        ++count;
+        sum += rr_ms;
+        sum_sq += (uint64_t)rr_ms * rr_ms;
+        addPair(diff[slot], 1);
+
+        while (sum > span && count > 1) {
+            evict();
+        }
+    }
+
+    // False until MIN_PAIRS successive differences are in the window
+    bool metrics(Metrics& out) const {
+        if (pairs < MIN_PAIRS || count < 2) {
+            return false;
+        }
+        const uint64_t n = count;
+        const uint64_t s = sum;
+        const uint64_t spread = n * sum_sq - s * s;    // >= 0 exactly
+        out.sdnn_ms = std::sqrt((float)spread / (float)(n * (n - 1)));
+        out.rmssd_ms = std::sqrt((float)diff_sq / (float)pairs);
+        out.pnn50_pct = 100.0f * (float)nn50 / (float)pairs;
+        out.mean_rr_ms = (float)s / (float)n;
+        out.intervals = (uint16_t)count;
+        out.pairs = (uint16_t)pairs;
+        return true;
+    }
+
+    std::size_t size() const { return count; }
+    uint32_t windowMs() const { return span; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr int16_t NO_DIFF = INT16_MIN;
+
+    static bool agrees(uint16_t rr_ms, uint16_t ref_ms) {
+        const int32_t d = (int32_t)rr_ms - (int32_t)ref_ms;
+        return (float)(d < 0 ? -d : d) <= ECTOPIC_FRACTION * (float)ref_ms;
+    }
+
+    void addPair(int32_t d, int sign) {
+        if (d == NO_DIFF) {
+            return;
+        }
+        const uint32_t sq = (uint32_t)(d * d);
+        const uint32_t big = (d > NN50_MS || d < -(int32_t)NN50_MS) ? 1u : 0u;
+        if (sign > 0) {
+            diff_sq += sq;
+            ++pairs;
+            nn50 += big;
+        } else {
+            diff_sq -= sq;
+            --pairs;
+            nn50 -= big;
+        }
+    }
+
+    // Drop the oldest interval and the pair it forms with the next one
+    void evict() {
+        sum -= rr[head];
+        sum_sq -= (uint64_t)rr[head] * rr[head];
+        head = (head + 1) % Capacity;
+        --count;
+        if (count) {
+            addPair(diff[head], -1);
+            diff[head] = NO_DIFF;
+        }
+    }
+
+    uint32_t span = 0;             // ms
+
+    uint16_t rr[Capacity]{};
+    int16_t diff[Capacity]{};      // to the predecessor, NO_DIFF if none
+    std::size_t head = 0;          // oldest
+    std::size_t count = 0;
+
+    uint32_t sum = 0;              // ms
+    uint64_t sum_sq = 0;           // ms^2
+    uint64_t diff_sq = 0;          // ms^2
+    uint32_t pairs = 0;
+    uint32_t nn50 = 0;
+
+    bool have_prev = false;
+    bool linked = false;           // prev is the beat just before the next one
+    uint16_t prev = 0;             // last accepted interval
+    uint16_t rejected = 0;         // interval rejected just before, 0 if none
+};
+
+#endif /* HRV_WINDOW_H */
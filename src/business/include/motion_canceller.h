@@ -0,0 +1,114 @@
+#ifndef MOTION_CANCELLER_H
+#define MOTION_CANCELLER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Adaptive motion-artifact canceller: an NLMS FIR filter per reference
+// channel (the band-passed accelerometer axes) predicts the motion-correlated
+// part of the band-passed PPG, which is subtracted in place.
+//
+//   y(n) = sum_r w_r . x_r(n)      e(n) = d(n) - y(n)
+//   w_r += mu * e(n) / (eps * Taps * Refs + |x(n)|^2) * x_r(n)
+//
+// eps is a floor on the reference power per tap: without motion the
+// references are sensor noise, and normalizing by their tiny energy alone
+// would let the weights grow until they fit the pulse itself.
+//
+// Memory is fixed: Taps weights and a 2*Taps mirrored delay line per
+// reference, so every window is contiguous and the dot product and the
+// weight update are plain unit-stride loops the compiler can vectorize.
+// The reference energy is a running sum (one add and one subtract per
+// reference and sample), recomputed exactly once per Taps samples so it
+// cannot drift. The PPG and the references must be time-aligned to within a
+// few samples; a constant lag is absorbed by the taps.
+template <std::size_t Taps, std::size_t Refs = 3>
+class MotionCanceller {
+public:
+    static_assert(Taps >= 1, "need at least one tap");
+    static_assert(Refs >= 1, "need at least one reference");
+
+    static constexpr float MU_DEFAULT = 0.02f;
+    static constexpr float EPS_DEFAULT = 0.01f;   // (0.1 m/s^2)^2
+
+    MotionCanceller() { reset(); }
+
+    // Step size (0 < mu < 2) and power floor per tap in reference units^2
+    void init(float step = MU_DEFAULT, float regularization = EPS_DEFAULT) {
+        mu = step;
+        eps = regularization;
+        reset();
+    }
+
+    // Zero the weights and the delay lines
+    void reset() {
+        for (auto &ch : w) for (auto &v : ch) v = 0.0f;
+        for (auto &ch : line) for (auto &v : ch) v = 0.0f;
+        for (auto &e : energy) e = 0.0f;
+        pos = 0;
+    }
+
+    // Cancel motion from n PPG samples in place. ref holds n frames of Refs
+    // interleaved reference samples (x, y, z), time-aligned with ppg.
+    void process(float* ppg, const float* ref, std::size_t n) noexcept {
+        if (!ppg || !ref) {
+            return; // no-op if invalid
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            // Newest sample first at line[r][pos .. pos + Taps - 1]; the slot
+            // being overwritten holds the sample leaving the window
+            pos = (pos == 0 ? Taps : pos) - 1;
+            float total = eps * (float)(Taps * Refs);
+            for (std::size_t r = 0; r < Refs; ++r) {
+                const float v = ref[i * Refs + r];
+                const float old = line[r][pos];
+                line[r][pos] = v;
+                line[r][pos + Taps] = v;
+                energy[r] += v * v - old * old;
+                if (pos == 0) {
+                    energy[r] = dot(line[r], line[r]);
+                }
+                total += energy[r] > 0.0f ? energy[r] : 0.0f;
+            }
+
+            float y = 0.0f;
+            for (std::size_t r = 0; r < Refs; ++r) {
+                y += dot(w[r], &line[r][pos]);
+            }
+            const float e = ppg[i] - y;
+            ppg[i] = e;
+
+            const float g = mu * e / total;
+            for (std::size_t r = 0; r < Refs; ++r) {
+                float* __restrict wr = w[r];
+                const float* __restrict xr = &line[r][pos];
+                for (std::size_t k = 0; k < Taps; ++k) {
+                    wr[k] += g * xr[k];
+                }
+            }
+        }
+    }
+
+    static constexpr std::size_t taps() { return Taps; }
+    static constexpr std::size_t refs() { return Refs; }
+
+    const float* weights(std::size_t r) const { return w[r]; }
+
+private:
+    static float dot(const float* __restrict a, const float* __restrict b) noexcept {
+        float s = 0.0f;
+        for (std::size_t k = 0; k < Taps; ++k) {
+            s += a[k] * b[k];
+        }
+        return s;
+    }
+
+    float mu = MU_DEFAULT;
+    float eps = EPS_DEFAULT;
+    float w[Refs][Taps];
+    float line[Refs][2 * Taps];
+    float energy[Refs];
+    std::size_t pos = 0;
+};
+
+#endif /* MOTION_CANCELLER_H */
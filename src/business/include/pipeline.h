@@ -0,0 +1,114 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#if __cplusplus < 201703L
+#error "pipeline.h needs C++17 (CONFIG_STD_CPP17)"
+#endif
+
+// Sample rate handed from stage to stage in Pipeline::init(): a stage that
+// changes the rate (decimator) updates hz for the stages behind it.
+struct PipelineRate {
+    uint32_t hz;            // rate of the samples reaching this stage
+    uint32_t target_hz;     // rate the pipeline should run at
+};
+
+// Block pipeline composed at compile time from its stage types.
+//
+// All stages work in place on one block buffer of Block samples owned by
+// the pipeline, in the order listed. A stage is any type with
+//
+//     bool init(PipelineRate& rate);           // start over at rate.hz
+//     void reset();                            // forget the signal, keep the rate
+//     void settle(float x);                    // steady state for a constant x
+//     std::size_t process(float* x, std::size_t n);  // returns samples out
+//
+// Dispatch is static: the stages live in a std::tuple, run() is a fold
+// over them, and every call is to a concrete member, so the compiler can
+// inline the whole chain into one loop nest. No virtuals, no heap, no
+// std::function. A stage that returns fewer samples than it got (decimator)
+// shrinks the block for the ones behind it; sinks (detector, estimators)
+// return n unchanged.
+//
+// RAM is fixed by the type: BUFFER_BYTES for the shared block plus
+// STATE_BYTES for the stages, both usable in static_asserts.
+template <std::size_t Block, typename... Stages>
+class Pipeline {
+public:
+    static_assert(Block > 0, "empty block");
+    static_assert(sizeof...(Stages) > 0, "no stages");
+
+    static constexpr std::size_t BLOCK = Block;
+    static constexpr std::size_t STAGES = sizeof...(Stages);
+    static constexpr std::size_t BUFFER_BYTES = Block * sizeof(float);
+    static constexpr std::size_t STATE_BYTES = (sizeof(Stages) + ...);
+
+    // Initialize the stages front to back at input rate fs_hz; stops at
+    // the first stage that cannot run at the rate it gets
+    bool init(uint32_t fs_hz, uint32_t target_hz) {
+        PipelineRate r{fs_hz, target_hz};
+        const bool ok = initAll(r, std::index_sequence_for<Stages...>{});
+        out_hz = ok ? r.hz : 0;
+        return ok;
+    }
+
+    void reset() {
+        std::apply([](auto&... s) { (s.reset(), ...); }, stages);
+    }
+
+    // Every stage sees the same level: the rate changers have unity DC gain
+    void settle(float x) {
+        std::apply([x](auto&... s) { (s.settle(x), ...); }, stages);
+    }
+
+    // The shared block; fill up to BLOCK input samples, then run()
+    float* data() { return buf.data(); }
+    const float* data() const { return buf.data(); }
+
+    // Run all stages over the first n samples of data(); returns how many
+    // samples the last stage left there
+    std::size_t run(std::size_t n) { return run<0, STAGES>(n); }
+
+    // Run stages [From, To) only, for callers that do other work between
+    // stages (taps of an intermediate signal, stages skipped by mode)
+    template <std::size_t From, std::size_t To>
+    std::size_t run(std::size_t n) {
+        static_assert(From <= To && To <= STAGES, "stage range out of bounds");
+        if (n > Block) {
+            n = Block;
+        }
+        return runRange<From>(n, std::make_index_sequence<To - From>{});
+    }
+
+    template <std::size_t I>
+    auto& stage() { return std::get<I>(stages); }
+    template <std::size_t I>
+    const auto& stage() const { return std::get<I>(stages); }
+
+    // Output rate after a successful init(), 0 before
+    uint32_t rate() const { return out_hz; }
+
+private:
+    template <std::size_t... I>
+    bool initAll(PipelineRate& r, std::index_sequence<I...>) {
+        return (std::get<I>(stages).init(r) && ...);
+    }
+
+    template <std::size_t From, std::size_t... I>
+    std::size_t runRange(std::size_t n, std::index_sequence<I...>) {
+        float* x = buf.data();
+        ((n = std::get<From + I>(stages).process(x, n)), ...);
+        return n;
+    }
+
+    std::tuple<Stages...> stages;
+    std::array<float, Block> buf{};
+    uint32_t out_hz = 0;
+};
+
+#endif /* PIPELINE_H */
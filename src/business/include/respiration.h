@@ -0,0 +1,103 @@
+#ifndef RESPIRATION_H
+#define RESPIRATION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "biquad.h"
+
+// Respiratory rate from the three respiratory modulations of the PPG:
+//
+//  - RIIV (intensity): the baseline, i.e. the raw samples minus the
+//    hr_filter output, which leaves the sub-cardiac band without filtering
+//    the raw stream again;
+//  - RIAV (amplitude): the beat detector's peak-to-trough height per beat;
+//  - RIFV (frequency): the RR interval per beat (respiratory sinus
+//    arrhythmia).
+//
+// The baseline is integrated and dumped at OUT_RATE_HZ, the per-beat values
+// are held until the next beat and sampled on the same clock. At that rate
+// the three series go through one 3-channel band-pass (BAND_LO_HZ ..
+// BAND_HI_HZ) and a zero-crossing counter each: a breath is an upward
+// crossing of +HYSTERESIS * RMS after the series was below -HYSTERESIS * RMS.
+// A series' rate is the mean of its last BREATHS breath intervals (running
+// sum over a small ring). The reported rate fuses the series whose rates
+// agree within FUSE_SPREAD_BRPM (smart fusion), so one modulation that is
+// weak in a given subject does not drag the estimate.
+class RespirationEstimator {
+public:
+    static constexpr uint32_t OUT_RATE_HZ = 4;
+    static constexpr double BAND_LO_HZ = 0.1;       // 6 breaths/min
+    static constexpr double BAND_HI_HZ = 0.6;       // 36 breaths/min
+    static constexpr float RMS_TAU_S = 10.0f;
+    static constexpr float HYSTERESIS = 0.3f;
+    static constexpr std::size_t BREATHS = 6;
+    static constexpr std::size_t MIN_BREATHS = 3;
+    static constexpr float FUSE_SPREAD_BRPM = 4.0f;
+
+    enum Series : std::size_t { RIIV = 0, RIAV, RIFV, SERIES };
+
+    struct Estimate {
+        float brpm;             // breaths per minute
+        uint8_t series;         // bit mask of the series that agreed
+    };
+
+    RespirationEstimator() { init(50); }
+
+    // Start over at sample rate fs_hz (Hz of the samples passed to process())
+    void init(uint32_t fs_hz);
+
+    // Forget the series and breaths, keep the rate
+    void reset();
+
+    // raw: the block before the band-pass, filtered: the hr_filter output
+    void process(const float* raw, const float* filtered, std::size_t n);
+
+    // One detected beat: its RR interval and peak-to-trough height
+    void addBeat(uint16_t rr_ms, float amplitude);
+
+    // False until at least two series agree
+    bool estimate(Estimate& out) const;
+
+    // Rate of one series; false until MIN_BREATHS intervals, or after a
+    // breath-length gap without crossings
+    bool seriesRate(Series s, float& brpm) const;
+
+private:
+    struct Counter {
+        float rms2 = 0.0f;
+        bool below = false;
+        bool have_last = false;
+        uint32_t last = 0;           // tick of the last breath
+        uint16_t ring[BREATHS]{};    // breath intervals in ticks
+        std::size_t head = 0;
+        std::size_t count = 0;
+        uint32_t sum = 0;
+    };
+
+    void tick(float baseline);
+    void count(Counter& c, float y);
+
+    uint32_t fs = 0;
+    float rms_alpha = 0.0f;
+    uint32_t min_breath = 0;         // ticks
+    uint32_t max_breath = 0;
+
+    BiquadCascadeMultiDF2T<2, SERIES> band;
+
+    // Integrate-and-dump of the baseline onto the OUT_RATE_HZ clock
+    uint32_t phase = 0;
+    float acc = 0.0f;
+    uint32_t acc_n = 0;
+
+    bool have_beat = false;
+    float amp_hold = 0.0f;
+    float rr_hold = 0.0f;
+    bool primed = false;
+    float offset[SERIES]{};          // first frame, keeps the band-pass quiet
+    uint32_t ticks = 0;
+
+    Counter counters[SERIES];
+};
+
+#endif /* RESPIRATION_H */
@@ -0,0 +1,219 @@
+#ifndef RHYTHM_WINDOW_H
+#define RHYTHM_WINDOW_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Rhythm-irregularity screening over the last Capacity RR intervals, for
+// atrial-fibrillation-like rhythms. Fixed memory, and per interval one
+// O(1) update of integer running sums plus at most three branch-free scans
+// of the ring for the entropy counts; queries are O(1).
+//
+//  - nRMSSD  = RMSSD / mean RR
+//  - SD1/SD2 = Poincare dispersion across vs. along the identity line,
+//              SD1^2 = var(rr[i] - rr[i-1]) / 2, SD2^2 = var(rr[i] + rr[i-1]) / 2
+//  - SampEn  = -ln(P(2-interval match) / P(1-interval match)), matches within
+//              a fixed MATCH_MS (Chebyshev), and the coefficient of sample
+//              entropy COSEn = SampEn + ln(2 * MATCH_MS / mean RR), which
+//              corrects for the rate.
+//
+// The entropy is the usual m = 1 sample entropy, approximated so that it can
+// be kept incrementally: with a fixed tolerance the number of matching
+// template pairs changes only by the matches of the interval that enters and
+// of the one (and its pair) that leaves. Single intervals and successive
+// pairs are counted over their own populations and compared as match
+// probabilities.
+//
+// Unlike HrvWindow there is no ectopic rejection: large successive changes
+// are what is being screened for. Intervals that do not directly follow
+// each other (gap, restart, beat rejected upstream) form no pair.
+//
+// Each index is compared with an AF-typical limit. Metrics::irregular
+// needs the entropy vote plus one of the other two: premature beats with
+// their compensatory pauses inflate nRMSSD and SD1/SD2 as much as AF does,
+// but they repeat, so their entropy stays low.
+template <std::size_t Capacity>
+class RhythmWindow {
+public:
+    static_assert(Capacity >= 8, "need a few intervals");
+
+    static constexpr uint16_t RR_MIN_MS = 250;
+    static constexpr uint16_t RR_MAX_MS = 2000;
+    static constexpr uint16_t MATCH_MS = 30;
+    static constexpr std::size_t MIN_PAIRS = Capacity / 2;
+
+    static constexpr float NRMSSD_LIMIT = 0.1f;
+    static constexpr float COSEN_LIMIT = -1.4f;
+    static constexpr float SD_RATIO_LIMIT = 0.75f;
+
+    struct Metrics {
+        float nrmssd;
+        float sd1_sd2;
+        float sampen;
+        float cosen;
+        float mean_rr_ms;
+        uint8_t votes;          // indices beyond their limit, 0..3
+        bool irregular;         // COSEn and nRMSSD or SD1/SD2 beyond their limits
+        uint16_t intervals;
+        uint16_t pairs;
+    };
+
+    RhythmWindow() { reset(); }
+
+    void reset() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cur[i] = 0;
+            pre[i] = 0;
+        }
+        head = 0;
+        count = 0;
+        sum = 0;
+        pairs = 0;
+        sum_d = 0;
+        sum_d2 = 0;
+        sum_s = 0;
+        sum_s2 = 0;
+        match1 = 0;
+        match2 = 0;
+        linked = false;
+    }
+
+    // One RR interval in ms; successive is false if it does not directly
+    // follow the previous one passed in
+    void add(uint16_t rr_ms, bool successive) {
+        if (rr_ms < RR_MIN_MS || rr_ms > RR_MAX_MS) {
+            linked = false;
+            return;
+        }
+        if (count == Capacity) {
+            evict();
+        }
+        const uint16_t before = (successive && linked && count) ? newest() : 0;
+        linked = true;
+
+        Scan m = scan(rr_ms, before);
+        match1 += m.single;
+        const std::size_t slot = (head + count) % Capacity;
+        cur[slot] = rr_ms;
+        pre[slot] = before;
+        ++count;
+        sum += rr_ms;
+        if (before) {
+            match2 += m.pair;
+            addPair(rr_ms, before, 1);
+        }
+    }
+
+    // False until MIN_PAIRS successive pairs are in the window
+    bool metrics(Metrics& out) const {
+        if (pairs < MIN_PAIRS || pairs < 2) {
+            return false;
+        }
+        const float n = (float)count;
+        const float p = (float)pairs;
+        out.mean_rr_ms = (float)sum / n;
+        out.nrmssd = std::sqrt((float)sum_d2 / p) / out.mean_rr_ms;
+
+        // SD1/SD2 = sqrt(var(d) / var(s)); the common factors cancel, and
+        // p * sum(x^2) - sum(x)^2 is exact in integers
+        const uint64_t np = pairs;
+        const uint64_t spread_d = np * sum_d2 - (uint64_t)((int64_t)sum_d * sum_d);
+        const uint64_t spread_s = np * sum_s2 - (uint64_t)sum_s * sum_s;
+        out.sd1_sd2 = spread_s ? std::sqrt((float)spread_d / (float)spread_s) : 0.0f;
+
+        // Match probabilities; no pair match at all is bounded as one
+        const float p1 = (float)match1 / (0.5f * n * (n - 1.0f));
+        const float p2 = (float)(match2 ? match2 : 1) / (0.5f * p * (p - 1.0f));
+        out.sampen = p1 > 0.0f ? std::log(p1 / p2) : 0.0f;
+        out.cosen = out.sampen + std::log(2.0f * (float)MATCH_MS / out.mean_rr_ms);
+
+        const bool entropy = out.cosen > COSEN_LIMIT;
+        const uint8_t spread = (uint8_t)((out.nrmssd > NRMSSD_LIMIT) + (out.sd1_sd2 > SD_RATIO_LIMIT));
+        out.votes = (uint8_t)(spread + entropy);
+        out.irregular = entropy && spread > 0;
+        out.intervals = (uint16_t)count;
+        out.pairs = (uint16_t)pairs;
+        return true;
+    }
+
+    std::size_t size() const { return count; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    struct Scan {
+        uint32_t single;        // slots with |cur - a| <= MATCH_MS
+        uint32_t pair;          // ... and |pre - b| <= MATCH_MS
+    };
+
+    static bool near(uint16_t a, uint16_t b) {
+        return (a > b ? a - b : b - a) <= MATCH_MS;
+    }
+
+    // Empty slots and missing predecessors hold 0, which never matches a
+    // valid interval, so the whole ring is scanned without branches
+    Scan scan(uint16_t a, uint16_t b) const {
+        Scan m{0, 0};
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            const uint32_t s = near(cur[i], a);
+            m.single += s;
+            m.pair += s & (uint32_t)near(pre[i], b);
+        }
+        return m;
+    }
+
+    uint16_t newest() const { return cur[(head + count - 1) % Capacity]; }
+
+    void addPair(uint16_t x, uint16_t y, int sign) {
+        const int32_t d = (int32_t)x - (int32_t)y;
+        const uint32_t s = (uint32_t)x + y;
+        if (sign > 0) {
+            ++pairs;
+            sum_d += d;
+            sum_d2 += (uint64_t)(d * d);
+            sum_s += s;
+            sum_s2 += (uint64_t)s * s;
+        } else {
+            --pairs;
+            sum_d -= d;
+            sum_d2 -= (uint64_t)(d * d);
+            sum_s -= s;
+            sum_s2 -= (uint64_t)s * s;
+        }
+    }
+
+    // Drop the oldest interval and the pair it forms with the next one
+    void evict() {
+        const std::size_t o = head;
+        const uint16_t x = cur[o];
+        match1 -= scan(x, 0).single - 1;        // its matches, not itself
+        const std::size_t next = (o + 1) % Capacity;
+        if (count > 1 && pre[next]) {
+            match2 -= scan(cur[next], pre[next]).pair - 1;
+            addPair(cur[next], pre[next], -1);
+            pre[next] = 0;
+        }
+        sum -= x;
+        cur[o] = 0;
+        head = next;
+        --count;
+    }
+
+    uint16_t cur[Capacity];         // RR by slot, 0 if empty
+    uint16_t pre[Capacity];         // the interval before it, 0 if no pair
+    std::size_t head = 0;           // oldest
+    std::size_t count = 0;
+
+    uint32_t sum = 0;               // ms
+    uint32_t pairs = 0;
+    int32_t sum_d = 0;              // successive differences, ms
+    uint64_t sum_d2 = 0;
+    uint32_t sum_s = 0;             // successive sums, ms
+    uint64_t sum_s2 = 0;
+    uint32_t match1 = 0;            // matching single-interval template pairs
+    uint32_t match2 = 0;            // matching two-interval template pairs
+
+    bool linked = false;            // the newest interval precedes the next one
+};
+
+#endif /* RHYTHM_WINDOW_H */
@@ -0,0 +1,130 @@
+#ifndef SOS_DESIGN_H
+#define SOS_DESIGN_H
+
+#include <cstddef>
+#include <array>
+
+#include "biquad.h"
+
+// Compile-time Butterworth design (bilinear transform with prewarping) into
+// second-order sections in the [b0,b1,b2,a1,a2] / a0=1 layout used by
+// BiquadDF2T. Tables for every sample rate are generated by the compiler and
+// land in flash as constants.
+
+// constexpr math, valid for 0 <= x <= pi/2 (all we need for pi*fc/fs)
+constexpr double sos_sin(double x) {
+    double term = x, sum = x;
+    for (int k = 1; k < 12; ++k) {
+        term *= -x * x / ((2.0 * k) * (2.0 * k + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sos_cos(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int k = 1; k < 12; ++k) {
+        term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sos_tan(double x) { return sos_sin(x) / sos_cos(x); }
+
+constexpr double SOS_PI = 3.14159265358979323846;
+
+enum class SosType { Lowpass, Highpass };
+
+// One 2nd-order section with corner fc (Hz) and quality factor q
+constexpr BiquadDF2T sos_section(SosType type, double fc, double fs, double q) {
+    const double k = sos_tan(SOS_PI * fc / fs);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+    BiquadDF2T s{};
+    if (type == SosType::Lowpass) {
+        s.b0 = (float)(k * k * norm);
+        s.b1 = (float)(2.0 * k * k * norm);
+        s.b2 = s.b0;
+    } else {
+        s.b0 = (float)norm;
+        s.b1 = (float)(-2.0 * norm);
+        s.b2 = s.b0;
+    }
+    s.a1 = (float)(2.0 * (k * k - 1.0) * norm);
+    s.a2 = (float)((1.0 - k / q + k * k) * norm);
+    return s;
+}
+
+// Even-order Butterworth as Order/2 sections, lowest Q first
+template <std::size_t Order>
+constexpr std::array<BiquadDF2T, Order / 2> sos_butterworth(SosType type, double fc, double fs) {
+    static_assert(Order >= 2 && Order % 2 == 0, "only even orders are supported");
+    std::array<BiquadDF2T, Order / 2> out{};
+    for (std::size_t i = 0; i < Order / 2; ++i) {
+        // Pole pair k = Order/2 - i has Q = 1 / (2 sin((2k-1) pi / (2 Order)))
+        const std::size_t k = Order / 2 - i;
+        const double q = 1.0 / (2.0 * sos_sin((2.0 * k - 1.0) * SOS_PI / (2.0 * Order)));
+        out[i] = sos_section(type, fc, fs, q);
+    }
+    return out;
+}
+
+// HR band-pass: 4th-order HP at 0.4 Hz followed by 2nd-order LP at 7 Hz
+constexpr double HR_BAND_HP_HZ = 0.4;
+constexpr double HR_BAND_LP_HZ = 7.0;
+
+constexpr BiquadCascadeDF2T<3> sos_hr_bandpass(double fs) {
+    BiquadCascadeDF2T<3> c{};
+    const auto hp = sos_butterworth<4>(SosType::Highpass, HR_BAND_HP_HZ, fs);
+    const auto lp = sos_butterworth<2>(SosType::Lowpass, HR_BAND_LP_HZ, fs);
+    c.sec[0] = hp[0];
+    c.sec[1] = hp[1];
+    c.sec[2] = lp[0];
+    return c;
+}
+
+// Single-section HR band-pass over the same edges: a 2nd-order band-pass
+// centred on the geometric mean of the prewarped edges, whose bandwidth is
+// their distance (constant 0 dB peak gain, 6 dB/octave skirts)
+constexpr BiquadCascadeDF2T<1> sos_hr_bandpass_single(double fs) {
+    const double kl = sos_tan(SOS_PI * HR_BAND_HP_HZ / fs);
+    const double kh = sos_tan(SOS_PI * HR_BAND_LP_HZ / fs);
+    const double k2 = kl * kh;                  // k^2 at the centre
+    const double bw = kh - kl;                  // k / Q
+    const double norm = 1.0 / (1.0 + bw + k2);
+    BiquadCascadeDF2T<1> c{};
+    c.sec[0].b0 = (float)(bw * norm);
+    c.sec[0].b1 = 0.0f;
+    c.sec[0].b2 = (float)(-bw * norm);
+    c.sec[0].a1 = (float)(2.0 * (k2 - 1.0) * norm);
+    c.sec[0].a2 = (float)((1.0 - bw + k2) * norm);
+    return c;
+}
+
+// DC blocker pole for the HP edge: bilinear one-pole high-pass at
+// HR_BAND_HP_HZ, y(n) = g * (x(n) - x(n-1)) + pole * y(n-1) with the gain
+// g = (1 + pole) / 2
+constexpr float sos_dc_pole(double fs) {
+    const double k = sos_tan(SOS_PI * HR_BAND_HP_HZ / fs);
+    return (float)((1.0 - k) / (1.0 + k));
+}
+
+// Moving-average length whose -3 dB point (0.443 fs / len) is closest to
+// HR_BAND_LP_HZ, clamped to 1..max_len
+constexpr uint8_t sos_average_len(double fs, std::size_t max_len) {
+    const double len = 0.443 * fs / HR_BAND_LP_HZ + 0.5;
+    return len < 1.0 ? 1 : (len > (double)max_len ? (uint8_t)max_len : (uint8_t)len);
+}
+
+// Stability triangle check for every section (|a2| < 1, |a1| < 1 + a2)
+template <std::size_t N>
+constexpr bool sos_is_stable(const BiquadCascadeDF2T<N>& c) {
+    for (std::size_t i = 0; i < N; ++i) {
+        const float a1 = c.sec[i].a1, a2 = c.sec[i].a2;
+        if (!(a2 < 1.0f && a2 > -1.0f)) return false;
+        if (!((a1 < 0.0f ? -a1 : a1) < 1.0f + a2)) return false;
+    }
+    return true;
+}
+
+#endif /* SOS_DESIGN_H */
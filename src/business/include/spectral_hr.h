@@ -0,0 +1,61 @@
+#ifndef SPECTRAL_HR_H
+#define SPECTRAL_HR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Frequency-domain BPM estimate from a bank of sliding-DFT bins covering the
+// cardiac band (BAND_LO_HZ..BAND_HI_HZ), fed with the hr_filter output.
+//
+// Each bin is updated once per sample (damped SDFT, one complex MAC per
+// bin), so the cost is flat instead of a burst of FFT work every window.
+// A Hann window is applied in the frequency domain from the neighbouring
+// bins; the dominant bin is refined by parabolic interpolation and the
+// confidence is the share of band power in the peak and its neighbours.
+class SpectralHr {
+public:
+    static constexpr float BAND_LO_HZ = 0.5f;   // 30 BPM
+    static constexpr float BAND_HI_HZ = 3.5f;   // 210 BPM
+    static constexpr float WINDOW_S = 8.0f;
+    static constexpr std::size_t WINDOW_MAX = 512;
+    static constexpr std::size_t BINS_MAX = 32;
+    // Damping keeps rounding errors in the recursion from accumulating
+    static constexpr float DAMPING = 0.9999f;
+
+    struct Estimate {
+        float bpm;
+        float confidence;   // 0..1, share of band power in the peak
+    };
+
+    SpectralHr() { init(50); }
+
+    // Window of WINDOW_S (at most WINDOW_MAX samples) at sample rate fs_hz
+    bool init(uint32_t fs_hz);
+
+    // Clear the window, keep the rate
+    void reset();
+
+    void process(const float* x, std::size_t n);
+
+    // Dominant frequency in the band; false until one full window was seen
+    bool estimate(Estimate& out) const;
+
+    std::size_t windowLength() const { return win; }
+    std::size_t binCount() const { return bins; }
+
+private:
+    uint32_t fs = 0;
+    std::size_t win = 0;
+    std::size_t k_lo = 0;          // first tracked bin (two below the band)
+    std::size_t bins = 0;          // band bins plus two guard bins each side
+    float r_n = 0.0f;              // DAMPING^win
+
+    float cos_k[BINS_MAX]{}, sin_k[BINS_MAX]{};   // DAMPING * e^{j 2 pi k / win}
+    float re[BINS_MAX]{}, im[BINS_MAX]{};
+
+    float ring[WINDOW_MAX]{};
+    std::size_t pos = 0;
+    std::size_t filled = 0;
+};
+
+#endif /* SPECTRAL_HR_H */
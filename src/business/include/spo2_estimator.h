@@ -0,0 +1,87 @@
+#ifndef SPO2_ESTIMATOR_H
+#define SPO2_ESTIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "window_stats.h"
+
+// Ratio-of-ratios SpO2 from the Red and IR PPG channels, O(1) per sample:
+//
+//  - DC per channel: one-pole low-pass (DC_TAU_S) of the raw samples, fed
+//    before the band-pass runs in place (updateDc());
+//  - AC per channel: peak-to-peak of the hr_filter output, the max - min of
+//    a sliding window (window_stats.h) longer than one beat (AC_WINDOW_S),
+//    smoothed over AVG_TAU_S (updateAc()).
+//
+// R = (ACr/DCr)/(ACir/DCir) is mapped through the quadratic calibration
+// SpO2 = CAL_A*R^2 + CAL_B*R + CAL_C (Maxim reference curve for the
+// MAX3010x optics) and clamped to SPO2_MIN..100 %.
+class Spo2Estimator {
+public:
+    static constexpr float DC_TAU_S = 1.0f;
+    static constexpr float AC_WINDOW_S = 1.6f;        // > one beat at 40 BPM
+    static constexpr std::size_t AC_RING = 256;         // AC_WINDOW_S at 100 Hz + a block
+    static constexpr float AVG_TAU_S = 3.0f;
+    static constexpr float WARMUP_S = 4.0f;
+    static constexpr float MIN_PERFUSION = 1e-4f;   // AC/DC, below: no pulse
+    static constexpr float R_MAX = 2.0f;
+    static constexpr float SPO2_MIN = 70.0f;
+
+    static constexpr float CAL_A = -45.060f;
+    static constexpr float CAL_B = 30.354f;
+    static constexpr float CAL_C = 94.845f;
+
+    struct Estimate {
+        float spo2;         // %
+        float ratio;        // R
+    };
+
+    Spo2Estimator() { init(50); }
+    Spo2Estimator(const Spo2Estimator&) = delete;
+    Spo2Estimator& operator=(const Spo2Estimator&) = delete;
+
+    // Start over at sample rate fs_hz (Hz of the samples passed in)
+    void init(uint32_t fs_hz);
+
+    // Forget levels and envelopes, keep the rate
+    void reset();
+
+    // Raw (or decimated, unfiltered) samples; the sign is ignored
+    void updateDc(const float* red, const float* ir, std::size_t n);
+
+    // The same samples after the band-pass
+    void updateAc(const float* red, const float* ir, std::size_t n);
+
+    // False until WARMUP_S of AC input, without a pulse on either channel,
+    // or if R is outside (0, R_MAX]
+    bool estimate(Estimate& out) const;
+
+    // Map a ratio through the calibration curve (clamped)
+    static float spo2FromRatio(float r);
+
+private:
+    using Ring = SampleRing<AC_RING>;
+    using Window = WindowExtrema<AC_RING>;
+
+    struct Channel {
+        float dc = 0.0f;
+        float ac = 0.0f;                // smoothed max - min
+    };
+
+    static void trackDc(Channel& c, float a, const float* x, std::size_t n, bool first);
+    void trackAc(Channel& c, Ring& ring, Window& win, const float* x, std::size_t n) const;
+
+    uint32_t fs = 0;
+    float dc_alpha = 0.0f;
+    float avg_alpha = 0.0f;
+    std::size_t warmup = 0;
+
+    Channel red_ch, ir_ch;
+    Ring red_ring, ir_ring;
+    Window red_win{red_ring, AC_RING / 2}, ir_win{ir_ring, AC_RING / 2};
+    bool dc_primed = false;
+    std::size_t seen = 0;               // AC samples, saturates at warmup
+};
+
+#endif /* SPO2_ESTIMATOR_H */
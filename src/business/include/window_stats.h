@@ -0,0 +1,284 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Sliding-window statistics over a shared sample ring, no heap.
+//
+// A SampleRing keeps the newest Capacity samples of one stream. Any number
+// of windows read the same ring, each over its own length, and catch up
+// with update() after the producer pushed:
+//
+//  - WindowMoments, mean and variance: Welford updates for the sample
+//    entering and the one leaving, O(1); resynchronized from the ring once
+//    per window length so float rounding cannot accumulate (amortized O(1));
+//  - WindowExtrema, min and max: monotonic deques of ring indices, amortized
+//    O(1) (each index is pushed and popped at most once);
+//  - WindowStats, both over the same window.
+//
+// A stage pays only for the statistics it reads.
+//
+// A window still needs the sample leaving it when it takes in a new one, so
+// size the ring for the longest window plus the samples pushed between two
+// updates (one pipeline block). Indices are absolute sample counts; a window
+// that fell further behind restarts on the newest samples, which is correct
+// but costs a rescan of its length. A power-of-two
+// Capacity turns the index arithmetic into masks and keeps the ring
+// consistent when the 32-bit count wraps.
+template <std::size_t Capacity, typename T = float>
+class SampleRing {
+public:
+    static_assert(Capacity >= 2, "need room for a window and a new sample");
+
+    void push(T x) {
+        buf[total % Capacity] = x;
+        ++total;
+    }
+
+    // Drop every sample; windows restart on their next update()
+    void clear() { total = 0; }
+
+    // Samples pushed since construction or clear()
+    uint32_t count() const { return total; }
+
+    // Sample number `index` (absolute); valid while count() - index <= Capacity
+    T at(uint32_t index) const { return buf[index % Capacity]; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    T buf[Capacity]{};
+    uint32_t total = 0;
+};
+
+namespace window_detail {
+
+// Common catch-up logic: a window over the last `length` ring samples that
+// takes in what the producer pushed since the previous update()
+template <std::size_t Capacity, typename T>
+class Cursor {
+public:
+    using Ring = SampleRing<Capacity, T>;
+
+    std::size_t windowLength() const { return length; }
+
+protected:
+    explicit Cursor(const Ring& r) : ring(r) {}
+
+    void clamp(std::size_t len) { length = len < 1 ? 1 : (len >= Capacity ? Capacity - 1 : len); }
+    void restart() { next = ring.count() > length ? ring.count() - (uint32_t)length : 0; }
+
+    // True if the ring was cleared or overwrote samples this window still
+    // needs; the caller then restarts on the newest samples
+    bool behind() const {
+        const uint32_t end = ring.count();
+        return end < next || end - next > Capacity - length;
+    }
+
+    const Ring& ring;
+    std::size_t length = Capacity;
+    uint32_t next = 0;             // next ring index to take in
+};
+
+} // namespace window_detail
+
+// Mean and variance of the last `len` ring samples (Welford)
+template <std::size_t Capacity, typename T = float>
+class WindowMoments : public window_detail::Cursor<Capacity, T> {
+    using Base = window_detail::Cursor<Capacity, T>;
+
+public:
+    explicit WindowMoments(const typename Base::Ring& r, std::size_t len) : Base(r) {
+        setLength(len);
+    }
+
+    // Window length in samples, clamped to 1..Capacity - 1; starts over
+    void setLength(std::size_t len) {
+        this->clamp(len);
+        reset();
+    }
+
+    // Forget the window; the next update() takes the newest samples
+    void reset() {
+        this->restart();
+        n = 0;
+        mu = 0.0f;
+        m2 = 0.0f;
+        since_sync = 0;
+    }
+
+    // Take in every sample pushed since the last call
+    void update() {
+        if (this->behind()) {
+            reset();
+        }
+        const uint32_t end = this->ring.count();
+        for (; this->next != end; ++this->next) {
+            add(this->next);
+        }
+    }
+
+    std::size_t size() const { return n; }
+    bool full() const { return n == this->length; }
+
+    float mean() const { return mu; }
+
+    // Sample variance (n - 1); 0 below two samples
+    float variance() const {
+        if (n < 2) return 0.0f;
+        const float v = m2 / (float)(n - 1);
+        return v > 0.0f ? v : 0.0f;
+    }
+
+private:
+    void add(uint32_t i) {
+        const float x = (float)this->ring.at(i);
+        if (n == this->length) {
+            // Swap the leaving sample for the new one at constant n
+            const float y = (float)this->ring.at(i - (uint32_t)this->length);
+            const float old_mu = mu;
+            mu += (x - y) / (float)n;
+            m2 += (x - y) * (x - mu + y - old_mu);
+        } else {
+            ++n;
+            const float d = x - mu;
+            mu += d / (float)n;
+            m2 += d * (x - mu);
+        }
+        if (++since_sync >= this->length && n == this->length) {
+            resync(i);
+        }
+    }
+
+    // Exact two-pass mean and M2 over the full window ending at sample last
+    void resync(uint32_t last) {
+        const uint32_t first = last + 1 - (uint32_t)this->length;
+        float s = 0.0f;
+        for (uint32_t i = first; i != last + 1; ++i) s += (float)this->ring.at(i);
+        mu = s / (float)this->length;
+        float q = 0.0f;
+        for (uint32_t i = first; i != last + 1; ++i) {
+            const float d = (float)this->ring.at(i) - mu;
+            q += d * d;
+        }
+        m2 = q;
+        since_sync = 0;
+    }
+
+    std::size_t n = 0;
+    float mu = 0.0f;
+    float m2 = 0.0f;
+    std::size_t since_sync = 0;
+};
+
+// Min and max of the last `len` ring samples (monotonic deques)
+template <std::size_t Capacity, typename T = float>
+class WindowExtrema : public window_detail::Cursor<Capacity, T> {
+    using Base = window_detail::Cursor<Capacity, T>;
+
+public:
+    explicit WindowExtrema(const typename Base::Ring& r, std::size_t len) : Base(r) {
+        setLength(len);
+    }
+
+    // Window length in samples, clamped to 1..Capacity - 1; starts over
+    void setLength(std::size_t len) {
+        this->clamp(len);
+        reset();
+    }
+
+    // Forget the window; the next update() takes the newest samples
+    void reset() {
+        this->restart();
+        max_q.clear();
+        min_q.clear();
+    }
+
+    // Take in every sample pushed since the last call
+    void update() {
+        if (this->behind()) {
+            reset();
+        }
+        const uint32_t end = this->ring.count();
+        for (; this->next != end; ++this->next) {
+            add(this->next);
+        }
+    }
+
+    bool empty() const { return max_q.empty(); }
+
+    // Extremes of the window; T{} while empty
+    T min() const { return min_q.empty() ? T{} : this->ring.at(min_q.front()); }
+    T max() const { return max_q.empty() ? T{} : this->ring.at(max_q.front()); }
+
+private:
+    // Ring-buffer deque of sample indices, at most Capacity of them
+    struct IndexDeque {
+        uint32_t idx[Capacity];
+        std::size_t head = 0;
+        std::size_t len = 0;
+
+        void clear() { head = 0; len = 0; }
+        bool empty() const { return len == 0; }
+        uint32_t front() const { return idx[head]; }
+        uint32_t back() const { return idx[(head + len - 1) % Capacity]; }
+        void popFront() { head = (head + 1) % Capacity; --len; }
+        void popBack() { --len; }
+        void pushBack(uint32_t i) { idx[(head + len) % Capacity] = i; ++len; }
+    };
+
+    void add(uint32_t i) {
+        const T x = this->ring.at(i);
+        const uint32_t out = i - (uint32_t)this->length;   // leaves the window
+        if (!max_q.empty() && max_q.front() == out) max_q.popFront();
+        if (!min_q.empty() && min_q.front() == out) min_q.popFront();
+
+        while (!max_q.empty() && !(this->ring.at(max_q.back()) > x)) max_q.popBack();
+        max_q.pushBack(i);
+        while (!min_q.empty() && !(this->ring.at(min_q.back()) < x)) min_q.popBack();
+        min_q.pushBack(i);
+    }
+
+    IndexDeque max_q;
+    IndexDeque min_q;
+};
+
+// Both: mean, variance, min and max over the same window
+template <std::size_t Capacity, typename T = float>
+class WindowStats {
+public:
+    using Ring = SampleRing<Capacity, T>;
+
+    explicit WindowStats(const Ring& r, std::size_t len)
+        : moments(r, len), extrema(r, len) {}
+
+    void setLength(std::size_t len) {
+        moments.setLength(len);
+        extrema.setLength(len);
+    }
+
+    void reset() {
+        moments.reset();
+        extrema.reset();
+    }
+
+    void update() {
+        moments.update();
+        extrema.update();
+    }
+
+    std::size_t size() const { return moments.size(); }
+    std::size_t windowLength() const { return moments.windowLength(); }
+    bool full() const { return moments.full(); }
+    float mean() const { return moments.mean(); }
+    float variance() const { return moments.variance(); }
+    T min() const { return extrema.min(); }
+    T max() const { return extrema.max(); }
+
+private:
+    WindowMoments<Capacity, T> moments;
+    WindowExtrema<Capacity, T> extrema;
+};
+
+#endif /* WINDOW_STATS_H */
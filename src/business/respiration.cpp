@@ -0,0 +1,170 @@
+// respiration.cpp
+#include "respiration.h"
+#include "sos_design.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double Q_BUTTERWORTH = 0.70710678118654752;
+constexpr BiquadDF2T RESP_HP = sos_section(SosType::Highpass, RespirationEstimator::BAND_LO_HZ,
+                                           RespirationEstimator::OUT_RATE_HZ, Q_BUTTERWORTH);
+constexpr BiquadDF2T RESP_LP = sos_section(SosType::Lowpass, RespirationEstimator::BAND_HI_HZ,
+                                           RespirationEstimator::OUT_RATE_HZ, Q_BUTTERWORTH);
+
+} // namespace
+
+void RespirationEstimator::init(uint32_t fs_hz) {
+    fs = fs_hz;
+    rms_alpha = 1.0f - std::exp(-1.0f / (RMS_TAU_S * (float)OUT_RATE_HZ));
+    min_breath = (uint32_t)((double)OUT_RATE_HZ / BAND_HI_HZ);
+    max_breath = (uint32_t)((double)OUT_RATE_HZ / BAND_LO_HZ);
+    band.setSection(0, RESP_HP);
+    band.setSection(1, RESP_LP);
+    reset();
+}
+
+void RespirationEstimator::reset() {
+    band.reset();
+    phase = 0;
+    acc = 0.0f;
+    acc_n = 0;
+    have_beat = false;
+    amp_hold = 0.0f;
+    rr_hold = 0.0f;
+    primed = false;
+    ticks = 0;
+    for (auto &c : counters) c = Counter{};
+}
+
+void RespirationEstimator::process(const float* raw, const float* filtered, std::size_t n) {
+    if (!raw || !filtered || fs == 0) {
+        return; // no-op if invalid
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += raw[i] - filtered[i];
+        ++acc_n;
+        phase += OUT_RATE_HZ;
+        if (phase >= fs) {
+            phase -= fs;
+            tick(acc / (float)acc_n);
+            acc = 0.0f;
+            acc_n = 0;
+        }
+    }
+}
+
+void RespirationEstimator::addBeat(uint16_t rr_ms, float amplitude) {
+    amp_hold = amplitude;
+    rr_hold = (float)rr_ms;
+    have_beat = true;
+}
+
+void RespirationEstimator::tick(float baseline) {
+    if (!have_beat) {
+        return; // RIAV and RIFV start with the first beat
+    }
+    float frame[SERIES] = { baseline, amp_hold, rr_hold };
+    if (!primed) {
+        for (std::size_t s = 0; s < SERIES; ++s) offset[s] = frame[s];
+        primed = true;
+    }
+    for (std::size_t s = 0; s < SERIES; ++s) frame[s] -= offset[s];
+    band.processFrame(frame);
+    ++ticks;
+    for (std::size_t s = 0; s < SERIES; ++s) {
+        count(counters[s], frame[s]);
+    }
+}
+
+void RespirationEstimator::count(Counter& c, float y) {
+    const float y2 = y * y;
+    c.rms2 += rms_alpha * (y2 - c.rms2);
+    const bool beyond = y2 > HYSTERESIS * HYSTERESIS * c.rms2;
+    if (!beyond) {
+        return;
+    }
+    if (y < 0.0f) {
+        c.below = true;
+        return;
+    }
+    if (!c.below) {
+        return;
+    }
+    c.below = false;
+    if (c.have_last) {
+        const uint32_t iv = ticks - c.last;
+        if (iv >= min_breath && iv <= max_breath) {
+            if (c.count == BREATHS) {
+                c.sum -= c.ring[c.head];
+            } else {
+                ++c.count;
+            }
+            c.ring[c.head] = (uint16_t)iv;
+            c.sum += iv;
+            c.head = (c.head + 1) % BREATHS;
+        } else {
+            c.count = 0;    // implausible breath: start a new run
+            c.sum = 0;
+        }
+    }
+    c.have_last = true;
+    c.last = ticks;
+}
+
+bool RespirationEstimator::seriesRate(Series s, float& brpm) const {
+    if (s >= SERIES) {
+        return false;
+    }
+    const Counter &c = counters[s];
+    if (c.count < MIN_BREATHS || c.sum == 0 || ticks - c.last > max_breath) {
+        return false;
+    }
+    brpm = 60.0f * (float)OUT_RATE_HZ * (float)c.count / (float)c.sum;
+    return true;
+}
+
+bool RespirationEstimator::estimate(Estimate& out) const {
+    float rate[SERIES];
+    bool ok[SERIES];
+    for (std::size_t s = 0; s < SERIES; ++s) {
+        ok[s] = seriesRate((Series)s, rate[s]);
+    }
+
+    // Largest set of series within FUSE_SPREAD_BRPM of each other; among
+    // pairs, the closest one
+    float best_spread = FUSE_SPREAD_BRPM;
+    uint8_t best = 0;
+    if (ok[0] && ok[1] && ok[2]) {
+        const float lo = std::fmin(rate[0], std::fmin(rate[1], rate[2]));
+        const float hi = std::fmax(rate[0], std::fmax(rate[1], rate[2]));
+        if (hi - lo <= FUSE_SPREAD_BRPM) {
+            best = 0x7;
+        }
+    }
+    for (std::size_t a = 0; best != 0x7 && a < SERIES; ++a) {
+        for (std::size_t b = a + 1; b < SERIES; ++b) {
+            if (!ok[a] || !ok[b]) continue;
+            const float spread = std::fabs(rate[a] - rate[b]);
+            if (spread <= best_spread) {
+                best_spread = spread;
+                best = (uint8_t)((1u << a) | (1u << b));
+            }
+        }
+    }
+    if (best == 0) {
+        return false;
+    }
+
+    float sum = 0.0f;
+    int k = 0;
+    for (std::size_t s = 0; s < SERIES; ++s) {
+        if (best & (1u << s)) {
+            sum += rate[s];
+            ++k;
+        }
+    }
+    out.brpm = sum / (float)k;
+    out.series = best;
+    return true;
+}
@@ -0,0 +1,108 @@
+// spectral_hr.cpp
+#include "spectral_hr.h"
+
+#include <cmath>
+
+bool SpectralHr::init(uint32_t fs_hz) {
+    // The band edge must stay below Nyquist with room for the guard bins
+    if ((float)fs_hz < 2.5f * BAND_HI_HZ) {
+        return false;
+    }
+    std::size_t w = (std::size_t)(WINDOW_S * (float)fs_hz);
+    if (w > WINDOW_MAX) w = WINDOW_MAX;
+
+    // Band bins plus two guard bins each side must fit the bank
+    const float bin_hz = (float)fs_hz / (float)w;
+    const std::size_t lo = (std::size_t)std::ceil(BAND_LO_HZ / bin_hz);
+    const std::size_t hi = (std::size_t)std::floor(BAND_HI_HZ / bin_hz);
+    if (lo < 2 || hi + 5 - lo > BINS_MAX) {
+        return false;
+    }
+    fs = fs_hz;
+    win = w;
+    k_lo = lo - 2;
+    bins = hi + 5 - lo;
+
+    const float pi = 3.14159265358979323846f;
+    for (std::size_t b = 0; b < bins; ++b) {
+        const float omega = 2.0f * pi * (float)(k_lo + b) / (float)win;
+        cos_k[b] = DAMPING * std::cos(omega);
+        sin_k[b] = DAMPING * std::sin(omega);
+    }
+    r_n = std::pow(DAMPING, (float)win);
+    reset();
+    return true;
+}
+
+void SpectralHr::reset() {
+    for (std::size_t b = 0; b < BINS_MAX; ++b) {
+        re[b] = 0.0f;
+        im[b] = 0.0f;
+    }
+    for (auto &v : ring) v = 0.0f;
+    pos = 0;
+    filled = 0;
+}
+
+void SpectralHr::process(const float* x, std::size_t n) {
+    if (!x || win == 0) {
+        return; // no-op if invalid
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        // S_k(n) = r e^{j w_k} S_k(n-1) + x(n) - r^N x(n-N)
+        const float d = x[i] - r_n * ring[pos];
+        ring[pos] = x[i];
+        pos = (pos + 1 == win) ? 0 : pos + 1;
+        if (filled < win) ++filled;
+
+        for (std::size_t b = 0; b < bins; ++b) {
+            const float r0 = re[b], i0 = im[b];
+            re[b] = r0 * cos_k[b] - i0 * sin_k[b] + d;
+            im[b] = r0 * sin_k[b] + i0 * cos_k[b];
+        }
+    }
+}
+
+bool SpectralHr::estimate(Estimate& out) const {
+    if (win == 0 || filled < win || bins < 5) {
+        return false;
+    }
+    // Hann window in the frequency domain: X[k]/2 - (X[k-1] + X[k+1])/4,
+    // for the band and the inner guard bins
+    float p[BINS_MAX];
+    for (std::size_t b = 1; b + 1 < bins; ++b) {
+        const float hr = 0.5f * re[b] - 0.25f * (re[b - 1] + re[b + 1]);
+        const float hi = 0.5f * im[b] - 0.25f * (im[b - 1] + im[b + 1]);
+        p[b] = hr * hr + hi * hi;
+    }
+    float total = 0.0f;
+    std::size_t best = 2;
+    for (std::size_t b = 2; b + 2 < bins; ++b) {
+        total += p[b];
+        if (p[b] > p[best]) best = b;
+    }
+    if (!(total > 0.0f)) {
+        return false;
+    }
+
+    // Parabolic interpolation on log power (exact for a Gaussian peak)
+    float delta = 0.0f;
+    if (p[best - 1] > 0.0f && p[best + 1] > 0.0f) {
+        const float la = std::log(p[best - 1]);
+        const float lb = std::log(p[best]);
+        const float lc = std::log(p[best + 1]);
+        const float den = la - 2.0f * lb + lc;
+        if (den < 0.0f) {
+            delta = 0.5f * (la - lc) / den;
+        }
+    }
+    // Neighbours count toward the peak only where they are inside the band
+    float peak = p[best];
+    if (best > 2) peak += p[best - 1];
+    if (best + 3 < bins) peak += p[best + 1];
+
+    const float hz = ((float)(k_lo + best) + delta) * (float)fs / (float)win;
+    out.bpm = 60.0f * hz;
+    out.confidence = peak / total;
+    return true;
+}
@@ -0,0 +1,97 @@
+// spo2_estimator.cpp
+#include "spo2_estimator.h"
+
+#include <cmath>
+
+void Spo2Estimator::init(uint32_t fs_hz) {
+    fs = fs_hz;
+    const float f = (float)(fs_hz ? fs_hz : 1);
+    dc_alpha = 1.0f - std::exp(-1.0f / (DC_TAU_S * f));
+    const std::size_t len = (std::size_t)(AC_WINDOW_S * f + 0.5f);
+    red_win.setLength(len);
+    ir_win.setLength(len);
+    avg_alpha = 1.0f - std::exp(-1.0f / (AVG_TAU_S * f));
+    warmup = (std::size_t)(WARMUP_S * f);
+    reset();
+}
+
+void Spo2Estimator::reset() {
+    red_ch = Channel{};
+    ir_ch = Channel{};
+    red_ring.clear();
+    ir_ring.clear();
+    red_win.reset();
+    ir_win.reset();
+    dc_primed = false;
+    seen = 0;
+}
+
+void Spo2Estimator::trackDc(Channel& c, float a, const float* x, std::size_t n, bool first) {
+    std::size_t i = 0;
+    if (first && n > 0) {
+        c.dc = std::fabs(x[0]);   // start on the level, not from zero
+        i = 1;
+    }
+    for (; i < n; ++i) {
+        c.dc += a * (std::fabs(x[i]) - c.dc);
+    }
+}
+
+void Spo2Estimator::trackAc(Channel& c, Ring& ring, Window& win, const float* x,
+                            std::size_t n) const {
+    // One window step and one smoothing step per block: the window is much
+    // longer than a block and AVG_TAU_S much longer still
+    float keep = 1.0f;
+    for (std::size_t i = 0; i < n; ++i) {
+        ring.push(x[i]);
+        keep *= 1.0f - avg_alpha;
+    }
+    win.update();
+    c.ac += (1.0f - keep) * ((win.max() - win.min()) - c.ac);
+}
+
+void Spo2Estimator::updateDc(const float* red, const float* ir, std::size_t n) {
+    if (!red || !ir || fs == 0 || n == 0) {
+        return; // no-op if invalid
+    }
+    trackDc(red_ch, dc_alpha, red, n, !dc_primed);
+    trackDc(ir_ch, dc_alpha, ir, n, !dc_primed);
+    dc_primed = true;
+}
+
+void Spo2Estimator::updateAc(const float* red, const float* ir, std::size_t n) {
+    if (!red || !ir || fs == 0) {
+        return; // no-op if invalid
+    }
+    trackAc(red_ch, red_ring, red_win, red, n);
+    trackAc(ir_ch, ir_ring, ir_win, ir, n);
+    seen = seen + n < warmup ? seen + n : warmup;
+}
+
+bool Spo2Estimator::estimate(Estimate& out) const {
+    if (fs == 0 || seen < warmup) {
+        return false;
+    }
+    if (!(red_ch.dc > 0.0f) || !(ir_ch.dc > 0.0f)) {
+        return false;
+    }
+    const float pr = red_ch.ac / red_ch.dc;
+    const float pi = ir_ch.ac / ir_ch.dc;
+    if (!(pr > MIN_PERFUSION) || !(pi > MIN_PERFUSION)) {
+        return false; // no pulse on one of the channels
+    }
+    const float r = pr / pi;
+    if (!(r <= R_MAX)) {
+        return false;
+    }
+    out.ratio = r;
+    out.spo2 = spo2FromRatio(r);
+    return true;
+}
+
+float Spo2Estimator::spo2FromRatio(float r) {
+    const float s = (CAL_A * r + CAL_B) * r + CAL_C;
+    if (s > 100.0f) return 100.0f;
+    if (s < SPO2_MIN) return SPO2_MIN;
+    return s;
+}
@@ -7,10 +7,13 @@
 
 #include <gatt/services/system_service.h>
 #include <gatt/gatt_common.h>
+#include "heart_rate.h"
 
+#include <zephyr/kernel.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/logging/log.h>
+#include <errno.h>
 #include <string.h>
 
 LOG_MODULE_REGISTER(system_service, LOG_LEVEL_INF);
@@ -19,12 +22,28 @@ LOG_MODULE_REGISTER(system_service, LOG_LEVEL_INF);
 static uint8_t sys_alert_reset = 0;
 static uint8_t sys_battery_lvl = 100;
 static char sys_fw_ver[] = "v1.0.0";
+/* Rhythm alert: irregular flag (0/1), then the number of indices beyond
+ * their limit (0..3) */
+static uint8_t sys_rhythm_alert[2] = { 0, 0 };
+/* Vital-sign alert rules, read back as the whole table; a write is the slot
+ * followed by one 8-byte hr_alert_rule_t */
+static hr_alert_rule_t sys_alert_rules[CONFIG_HR_ALERT_RULES];
+/* Last raised vital-sign alert, hr_alert_t (4 bytes), zero once reset */
+static hr_alert_t sys_alert_event;
+/* Guards the rhythm alert and the alert event, written from the HR thread,
+ * against the BT handlers */
+static struct k_spinlock sys_lock;
 
 static void sys_batt_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
     LOG_INF("Battery level CCC configuration changed: 0x%04x", value);
 }
 
+static void sys_rhythm_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    LOG_INF("Rhythm alert CCC configuration changed: 0x%04x", value);
+}
+
 static ssize_t write_alert_reset(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                 const void *buf, uint16_t len, uint16_t offset, uint8_t flags)
 {
@@ -40,6 +59,11 @@ static ssize_t write_alert_reset(struct bt_conn *conn, const struct bt_gatt_attr
     if (sys_alert_reset) {
         LOG_INF("Processing alert reset...");
         /* Reset alert conditions, clear error states, etc. */
+        heart_rate_clear_alerts();
+        K_SPINLOCK(&sys_lock) {
+            sys_rhythm_alert[0] = 0;
+            memset(&sys_alert_event, 0, sizeof(sys_alert_event));
+        }
         sys_alert_reset = 0; /* Clear after processing */
     }
     
@@ -52,6 +76,63 @@ static ssize_t read_battery_lvl(struct bt_conn *conn, const struct bt_gatt_attr
     return bt_gatt_attr_read(conn, attr, buf, len, offset, &sys_battery_lvl, sizeof(sys_battery_lvl));
 }
 
+static ssize_t read_rhythm_alert(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                 void *buf, uint16_t len, uint16_t offset)
+{
+    uint8_t value[sizeof(sys_rhythm_alert)];
+
+    K_SPINLOCK(&sys_lock) {
+        memcpy(value, sys_rhythm_alert, sizeof(value));
+    }
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(value));
+}
+
+static ssize_t read_alert_rules(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                void *buf, uint16_t len, uint16_t offset)
+{
+    for (uint8_t i = 0; i < CONFIG_HR_ALERT_RULES; i++) {
+        heart_rate_get_alert_rule(i, &sys_alert_rules[i]);
+    }
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, sys_alert_rules, sizeof(sys_alert_rules));
+}
+
+static ssize_t write_alert_rule(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                const void *buf, uint16_t len, uint16_t offset, uint8_t flags)
+{
+    hr_alert_rule_t rule;
+
+    if (offset != 0 || len != 1 + sizeof(rule)) {
+        LOG_ERR("Invalid length for alert rule");
+        return GATT_ERR_INVALID_LENGTH;
+    }
+
+    const uint8_t slot = ((const uint8_t *)buf)[0];
+    memcpy(&rule, (const uint8_t *)buf + 1, sizeof(rule));
+    if (!heart_rate_set_alert_rule(slot, &rule)) {
+        LOG_ERR("Alert rule rejected for slot %d", slot);
+        return GATT_ERR_VALUE_NOT_ALLOWED;
+    }
+    LOG_INF("Alert rule %d set in slot %d", rule.id, slot);
+
+    return len;
+}
+
+static ssize_t read_alert_event(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                void *buf, uint16_t len, uint16_t offset)
+{
+    hr_alert_t value;
+
+    K_SPINLOCK(&sys_lock) {
+        value = sys_alert_event;
+    }
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, &value, sizeof(value));
+}
+
+static void sys_alert_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    LOG_INF("Alert event CCC configuration changed: 0x%04x", value);
+}
+
 static ssize_t read_fw_ver(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                            void *buf, uint16_t len, uint16_t offset)
 {
@@ -73,10 +154,45 @@ BT_GATT_SERVICE_DEFINE(system_svc,
         BT_GATT_CHRC_READ,
         BT_GATT_PERM_READ,
         read_fw_ver, NULL, sys_fw_ver),
+    BT_GATT_CHARACTERISTIC(GATT_DECLARE_128_UUID(SYS_RHYTHM_ALERT_UUID),
+        BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+        BT_GATT_PERM_READ,
+        read_rhythm_alert, NULL, sys_rhythm_alert),
+    BT_GATT_CCC(sys_rhythm_ccc_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+    BT_GATT_CHARACTERISTIC(GATT_DECLARE_128_UUID(SYS_ALERT_RULES_UUID),
+        BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE,
+        BT_GATT_PERM_READ | BT_GATT_PERM_WRITE,
+        read_alert_rules, write_alert_rule, sys_alert_rules),
+    BT_GATT_CHARACTERISTIC(GATT_DECLARE_128_UUID(SYS_ALERT_EVENT_UUID),
+        BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+        BT_GATT_PERM_READ,
+        read_alert_event, NULL, &sys_alert_event),
+    BT_GATT_CCC(sys_alert_ccc_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
 );
 
+/* Called from the HR thread for each raised vital-sign alert */
+static void sys_alert_raised(const hr_alert_t *alert)
+{
+    K_SPINLOCK(&sys_lock) {
+        sys_alert_event = *alert;
+    }
+
+    int err = bt_gatt_notify(NULL, &system_svc.attrs[13], alert, sizeof(*alert));
+    if (err) {
+        LOG_DBG("Alert event not sent (err %d)", err);
+    }
+}
+
+/* Called from the HR thread when the irregular flag changes */
+static void sys_rhythm_changed(const hr_rhythm_t *rhythm)
+{
+    system_service_notify_rhythm(rhythm->irregular, rhythm->votes);
+}
+
 int system_service_init(void)
 {
+    heart_rate_set_alert_callback(sys_alert_raised);
+    heart_rate_set_rhythm_callback(sys_rhythm_changed);
     LOG_INF("System service initialized");
     return 0;
 }
@@ -95,3 +211,24 @@ void system_service_simulate_battery_notify(void)
         LOG_DBG("Battery level notification sent: %d%%", sys_battery_lvl);
     }
 }
+
+int system_service_notify_rhythm(bool irregular, uint8_t votes)
+{
+    uint8_t value[sizeof(sys_rhythm_alert)];
+
+    K_SPINLOCK(&sys_lock) {
+        sys_rhythm_alert[0] = irregular ? 1 : 0;
+        sys_rhythm_alert[1] = votes;
+        memcpy(value, sys_rhythm_alert, sizeof(value));
+    }
+
+    int err = bt_gatt_notify(NULL, &system_svc.attrs[8], value, sizeof(value));
+    if (err == -ENOTCONN) {
+        LOG_DBG("Rhythm alert not sent, no connection");
+    } else if (err) {
+        LOG_ERR("Failed to send rhythm alert notification (err %d)", err);
+    } else {
+        LOG_DBG("Rhythm alert notification sent: %d (%d)", irregular, votes);
+    }
+    return err;
+}
@@ -7,14 +7,17 @@
 
 #include <gatt/services/vitals_service.h>
 #include <gatt/gatt_common.h>
+#include "heart_rate.h"
 
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/logging/log.h>
+#include <errno.h>
+#include <math.h>
 
 LOG_MODULE_REGISTER(vitals_service, LOG_LEVEL_INF);
 
-/* Service data */
-static uint8_t vitals_hr_spo2 = 75;
+/* Service data: heart rate in BPM, SpO2 in % (0 = no valid value) */
+static uint8_t vitals_hr_spo2[2] = { 75, 0 };
 
 static void vitals_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
@@ -26,27 +29,58 @@ BT_GATT_SERVICE_DEFINE(vitals_svc,
     BT_GATT_CHARACTERISTIC(GATT_DECLARE_128_UUID(VITALS_HR_SPO2_UUID),
         BT_GATT_CHRC_NOTIFY,
         BT_GATT_PERM_NONE,
-        NULL, NULL, &vitals_hr_spo2),
+        NULL, NULL, vitals_hr_spo2),
     BT_GATT_CCC(vitals_ccc_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
 );
 
+static uint8_t vitals_to_u8(bool valid, float v)
+{
+    if (!valid) {
+        return 0;
+    }
+    long r = lroundf(v);
+    return (uint8_t)(r < 1 ? 1 : (r > 255 ? 255 : r));
+}
+
+/* Called from the HR thread once per block; notifies when a value changes */
+static void vitals_published(const hr_vitals_t *vitals)
+{
+    const uint8_t hr = vitals_to_u8(vitals->bpm_valid, vitals->bpm);
+    const uint8_t spo2 = vitals_to_u8(vitals->spo2_valid, vitals->spo2);
+
+    if (hr != vitals_hr_spo2[0] || spo2 != vitals_hr_spo2[1]) {
+        vitals_service_notify(hr, spo2);
+    }
+}
+
 int vitals_service_init(void)
 {
+    heart_rate_set_vitals_callback(vitals_published);
     LOG_INF("Vitals service initialized");
     return 0;
 }
 
-void vitals_service_simulate_notify(void)
+int vitals_service_notify(uint8_t hr_bpm, uint8_t spo2_pct)
 {
-    vitals_hr_spo2++;
-    if (vitals_hr_spo2 > 200) {
-        vitals_hr_spo2 = 60; /* Reset to reasonable heart rate */
-    }
-    
-    int err = bt_gatt_notify(NULL, &vitals_svc.attrs[1], &vitals_hr_spo2, sizeof(vitals_hr_spo2));
-    if (err) {
+    vitals_hr_spo2[0] = hr_bpm;
+    vitals_hr_spo2[1] = spo2_pct;
+
+    int err = bt_gatt_notify(NULL, &vitals_svc.attrs[1], vitals_hr_spo2, sizeof(vitals_hr_spo2));
+    if (err == -ENOTCONN) {
+        LOG_DBG("Vitals not sent, no connection");
+    } else if (err) {
         LOG_ERR("Failed to send vitals notification (err %d)", err);
     } else {
-        LOG_DBG("Vitals notification sent: HR/SpO2 = %d", vitals_hr_spo2);
+        LOG_DBG("Vitals notification sent: HR = %d, SpO2 = %d", hr_bpm, spo2_pct);
+    }
+    return err;
+}
+
+void vitals_service_simulate_notify(void)
+{
+    uint8_t hr_bpm = vitals_hr_spo2[0] + 1;
+    if (hr_bpm > 200) {
+        hr_bpm = 60; /* Reset to reasonable heart rate */
     }
+    vitals_service_notify(hr_bpm, 97);
 }
@@ -30,10 +30,14 @@
 #define SYS_ALERT_RESET_UUID        BT_UUID_128_ENCODE(0x12345678, 0xA201, 0x1000, 0x8000, 0x00805F9B34FB)
 #define SYS_BATTERY_LVL_UUID        BT_UUID_128_ENCODE(0x12345678, 0xA202, 0x1000, 0x8000, 0x00805F9B34FB)
 #define SYS_FW_VER_UUID             BT_UUID_128_ENCODE(0x12345678, 0xA203, 0x1000, 0x8000, 0x00805F9B34FB)
+#define SYS_RHYTHM_ALERT_UUID       BT_UUID_128_ENCODE(0x12345678, 0xA204, 0x1000, 0x8000, 0x00805F9B34FB)
+#define SYS_ALERT_RULES_UUID        BT_UUID_128_ENCODE(0x12345678, 0xA205, 0x1000, 0x8000, 0x00805F9B34FB)
+#define SYS_ALERT_EVENT_UUID        BT_UUID_128_ENCODE(0x12345678, 0xA206, 0x1000, 0x8000, 0x00805F9B34FB)
 
 /* Common GATT Error Responses */
 #define GATT_ERR_INVALID_LENGTH     BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN)
 #define GATT_ERR_INSUFFICIENT_PERM  BT_GATT_ERR(BT_ATT_ERR_INSUFFICIENT_AUTHORIZATION)
+#define GATT_ERR_VALUE_NOT_ALLOWED  BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED)
 
 /* GATT Helper Macros */
 #define GATT_DECLARE_128_UUID(uuid_val) BT_UUID_DECLARE_128(uuid_val)
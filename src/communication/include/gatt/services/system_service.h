@@ -8,13 +8,34 @@
 #ifndef SYSTEM_SERVICE_H_
 #define SYSTEM_SERVICE_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 /**
  * @brief Initialize the system service
+ *
+ * Also subscribes to the heart-rate vital-sign alerts: each raised alert
+ * is notified on the alert event characteristic, and a write to the alert
+ * reset characteristic acknowledges them.
  * 
  * @return 0 on success, negative error code on failure
  */
 int system_service_init(void);
 
+/**
+ * @brief Update the rhythm alert characteristic and notify subscribers
+ *
+ * The characteristic value is two bytes: the irregular-rhythm flag (0/1),
+ * then the number of irregularity indices beyond their limit (0..3). A
+ * write to the alert reset characteristic clears the flag. The service
+ * calls this itself whenever the heart-rate module's irregular flag changes.
+ *
+ * @param irregular AF-like rhythm screened
+ * @param votes Indices beyond their limit
+ * @return 0 on success, negative error code on failure
+ */
+int system_service_notify_rhythm(bool irregular, uint8_t votes);
+
 /**
  * @brief Simulate battery level notification (for demo purposes)
  */
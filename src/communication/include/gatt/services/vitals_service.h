@@ -8,13 +8,30 @@
 #ifndef VITALS_SERVICE_H_
 #define VITALS_SERVICE_H_
 
+#include <stdint.h>
+
 /**
  * @brief Initialize the vitals service
+ *
+ * Also subscribes to the heart-rate vitals: the characteristic follows the
+ * tracked HR and the SpO2 estimate, notified whenever either changes.
  * 
  * @return 0 on success, negative error code on failure
  */
 int vitals_service_init(void);
 
+/**
+ * @brief Update the HR/SpO2 characteristic and notify subscribers
+ *
+ * The characteristic value is two bytes: heart rate in BPM, then SpO2 in %.
+ * Pass 0 for a value that is currently not valid.
+ *
+ * @param hr_bpm Heart rate in BPM
+ * @param spo2_pct SpO2 in percent
+ * @return 0 on success, negative error code on failure
+ */
+int vitals_service_notify(uint8_t hr_bpm, uint8_t spo2_pct);
+
 /**
  * @brief Simulate vitals notification (for demo purposes)
  */
@@ -0,0 +1,203 @@
+/*
+ * CareLoop Hardware Abstraction Layer - Streaming Hampel Spike Filter
+ * Copyright (c) 2025
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "hal_hampel.h"
+#include <math.h>
+
+/* pos[] flag: the slot sits in the upper (min-)heap */
+#define MEDIAN_HI   0x80u
+
+/* Heap order: lo is a max-heap, hi a min-heap */
+static inline bool above(const hal_median_t *m, bool hi, uint8_t a, uint8_t b)
+{
+    return hi ? m->val[a] < m->val[b] : m->val[a] > m->val[b];
+}
+
+static inline void place(hal_median_t *m, bool hi, uint8_t *heap, uint8_t i, uint8_t slot)
+{
+    heap[i] = slot;
+    m->pos[slot] = (uint8_t)(i | (hi ? MEDIAN_HI : 0u));
+}
+
+static void sift_up(hal_median_t *m, bool hi, uint8_t i)
+{
+    uint8_t *heap = hi ? m->hi : m->lo;
+    const uint8_t slot = heap[i];
+    while (i > 0) {
+        const uint8_t parent = (uint8_t)((i - 1) / 2);
+        if (!above(m, hi, slot, heap[parent])) {
+            break;
+        }
+        place(m, hi, heap, i, heap[parent]);
+        i = parent;
+    }
+    place(m, hi, heap, i, slot);
+}
+
+static void sift_down(hal_median_t *m, bool hi, uint8_t i)
+{
+    uint8_t *heap = hi ? m->hi : m->lo;
+    const uint8_t n = hi ? m->n_hi : m->n_lo;
+    const uint8_t slot = heap[i];
+    for (;;) {
+        uint8_t child = (uint8_t)(2 * i + 1);
+        if (child >= n) {
+            break;
+        }
+        if (child + 1 < n && above(m, hi, heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!above(m, hi, heap[child], slot)) {
+            break;
+        }
+        place(m, hi, heap, i, heap[child]);
+        i = child;
+    }
+    place(m, hi, heap, i, slot);
+}
+
+static void heap_push(hal_median_t *m, bool hi, uint8_t slot)
+{
+    uint8_t *heap = hi ? m->hi : m->lo;
+    uint8_t i = hi ? m->n_hi++ : m->n_lo++;
+    place(m, hi, heap, i, slot);
+    sift_up(m, hi, i);
+}
+
+static uint8_t heap_pop(hal_median_t *m, bool hi)
+{
+    uint8_t *heap = hi ? m->hi : m->lo;
+    const uint8_t top = heap[0];
+    const uint8_t last = hi ? --m->n_hi : --m->n_lo;
+    if (last > 0) {
+        place(m, hi, heap, 0, heap[last]);
+        sift_down(m, hi, 0);
+    }
+    return top;
+}
+
+void hal_median_init(hal_median_t *m, uint8_t window)
+{
+    if (!m) {
+        return;
+    }
+    if (window < HAL_HAMPEL_MIN_WINDOW) {
+        window = HAL_HAMPEL_MIN_WINDOW;
+    }
+    if (window > HAL_HAMPEL_MAX_WINDOW) {
+        window = HAL_HAMPEL_MAX_WINDOW;
+    }
+    m->window = (uint8_t)(window | 1u);
+    hal_median_reset(m);
+}
+
+void hal_median_reset(hal_median_t *m)
+{
+    if (!m) {
+        return;
+    }
+    m->n_lo = 0;
+    m->n_hi = 0;
+    m->next = 0;
+}
+
+float hal_median_push(hal_median_t *m, float x)
+{
+    const uint8_t slot = m->next;
+    m->next = (uint8_t)(m->next + 1 == m->window ? 0 : m->next + 1);
+
+    if (m->n_lo + m->n_hi < m->window) {
+        /* Filling: insert on the right side, then rebalance n_lo - n_hi to 0..1 */
+        m->val[slot] = x;
+        heap_push(m, m->n_lo > 0 && x > m->val[m->lo[0]], slot);
+        if (m->n_lo > m->n_hi + 1) {
+            heap_push(m, true, heap_pop(m, false));
+        } else if (m->n_hi > m->n_lo) {
+            heap_push(m, false, heap_pop(m, true));
+        }
+    } else {
+        /* Full: overwrite the oldest in place, restore its heap ... */
+        const bool hi = (m->pos[slot] & MEDIAN_HI) != 0;
+        const uint8_t i = (uint8_t)(m->pos[slot] & ~MEDIAN_HI);
+        m->val[slot] = x;
+        sift_up(m, hi, i);
+        sift_down(m, hi, (uint8_t)(m->pos[slot] & ~MEDIAN_HI));
+        /* ... and the split: only the moved value can be on the wrong side */
+        if (m->n_hi > 0 && m->val[m->lo[0]] > m->val[m->hi[0]]) {
+            const uint8_t a = m->lo[0], b = m->hi[0];
+            place(m, false, m->lo, 0, b);
+            place(m, true, m->hi, 0, a);
+            sift_down(m, false, 0);
+            sift_down(m, true, 0);
+        }
+    }
+
+    if (m->n_lo > m->n_hi) {
+        return m->val[m->lo[0]];
+    }
+    return 0.5f * (m->val[m->lo[0]] + m->val[m->hi[0]]);
+}
+
+void hal_hampel_init(hal_hampel_t *h, uint8_t window, float n_sigma, float min_dev)
+{
+    if (!h) {
+        return;
+    }
+    hal_median_init(&h->values, window);
+    hal_median_init(&h->diffs, window);
+    h->n_sigma = n_sigma;
+    h->min_dev = min_dev;
+    h->replaced = 0;
+    hal_hampel_reset(h);
+}
+
+void hal_hampel_reset(hal_hampel_t *h)
+{
+    if (!h) {
+        return;
+    }
+    hal_median_reset(&h->values);
+    hal_median_reset(&h->diffs);
+    h->prev = 0.0f;
+}
+
+bool hal_hampel_update(hal_hampel_t *h, float *x)
+{
+    if (!h || !x) {
+        return false;
+    }
+    hal_median_t *v = &h->values;
+    const bool first = v->n_lo + v->n_hi == 0;
+    const float raw = *x;
+    const float med = hal_median_push(v, raw);
+    const float spread = hal_median_push(&h->diffs, first ? 0.0f : fabsf(raw - h->prev));
+    h->prev = raw;
+
+    /* Keep the window / 2 delay while filling (slots fill from 0) */
+    const uint8_t half = (uint8_t)(v->window / 2);
+    const uint8_t count = (uint8_t)(v->n_lo + v->n_hi);
+    if (count < v->window) {
+        *x = v->val[count > half ? count - 1 - half : 0];
+        return false;
+    }
+    /* v->next is the oldest slot now; the center is window / 2 newer */
+    uint8_t center = (uint8_t)(v->next + half);
+    if (center >= v->window) {
+        center = (uint8_t)(center - v->window);
+    }
+    const float c = v->val[center];
+    float sigma = (HAL_HAMPEL_MAD_SCALE / 1.41421356f) * spread;
+    if (sigma < h->min_dev) {
+        sigma = h->min_dev;
+    }
+    if (fabsf(c - med) <= h->n_sigma * sigma) {
+        *x = c;
+        return false;
+    }
+    *x = med;
+    h->replaced++;
+    return true;
+}
@@ -0,0 +1,141 @@
+/*
+ * CareLoop Hardware Abstraction Layer - PPG Signal Quality Index
+ * Copyright (c) 2025
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "hal_sqi.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Perfusion index (sinusoid-equivalent peak-to-peak / DC) for score 0 and 1 */
+#define SQI_PI_MIN          0.0005f
+#define SQI_PI_GOOD         0.003f
+/* Skewness of the pulse (blood volume up) that scores 1; 0 scores 0.5 */
+#define SQI_SKEW_GOOD       0.5f
+/* Zero-crossing hysteresis in pulse RMS, interval smoothing per crossing */
+#define SQI_ZC_HYST         0.3f
+#define SQI_ZC_ALPHA        0.25f
+#define SQI_BPM_MIN         30.0f
+#define SQI_BPM_MAX         220.0f
+/* Share of the AC power below HAL_SQI_PULSE_HZ that scores 0 */
+#define SQI_CONC_MIN        0.2f
+
+#define SQI_W_REGULARITY    0.5f
+#define SQI_W_CONCENTRATION 0.3f
+#define SQI_W_SKEWNESS      0.2f
+
+static inline float clamp01(float v)
+{
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+void hal_sqi_init(hal_sqi_t *sqi, uint32_t fs_hz)
+{
+    if (!sqi) {
+        return;
+    }
+    float fs = (float)(fs_hz ? fs_hz : 1);
+    sqi->fs = fs;
+    sqi->a_dc = 1.0f - expf(-1.0f / (HAL_SQI_DC_TAU_S * fs));
+    sqi->a_lp = 1.0f - expf(-2.0f * 3.14159265f * HAL_SQI_PULSE_HZ / fs);
+    sqi->a_win = 1.0f - expf(-1.0f / (HAL_SQI_WINDOW_S * fs));
+    hal_sqi_reset(sqi);
+}
+
+void hal_sqi_reset(hal_sqi_t *sqi)
+{
+    if (!sqi) {
+        return;
+    }
+    size_t keep = offsetof(hal_sqi_t, dc);
+    memset((uint8_t *)sqi + keep, 0, sizeof(*sqi) - keep);
+}
+
+/* Rising crossing of the pulse through zero, with hysteresis */
+static void update_crossings(hal_sqi_t *sqi, float y, float rms)
+{
+    const float lo = sqi->fs * 60.0f / SQI_BPM_MAX;
+    const float hi = sqi->fs * 60.0f / SQI_BPM_MIN;
+    const float h = SQI_ZC_HYST * rms;
+
+    if (sqi->since_zc < UINT32_MAX) {
+        sqi->since_zc++;
+    }
+    if (y < -h) {
+        sqi->zc_armed = 1;
+    } else if (y > h && sqi->zc_armed) {
+        sqi->zc_armed = 0;
+        float interval = (float)sqi->since_zc;
+        if (interval > 2.0f * hi) {
+            interval = 2.0f * hi;
+        }
+        if (sqi->zc_mean == 0.0f) {
+            sqi->zc_mean = interval;    /* first crossing */
+        } else {
+            sqi->zc_dev += SQI_ZC_ALPHA * (fabsf(interval - sqi->zc_mean) - sqi->zc_dev);
+            sqi->zc_mean += SQI_ZC_ALPHA * (interval - sqi->zc_mean);
+        }
+        sqi->since_zc = 0;
+    }
+
+    if (sqi->zc_mean < lo || sqi->zc_mean > hi || (float)sqi->since_zc > hi) {
+        sqi->regularity = 0.0f;         /* out of range or no beat */
+    } else {
+        sqi->regularity = clamp01(1.0f - 2.0f * sqi->zc_dev / sqi->zc_mean);
+    }
+}
+
+hal_quality_t hal_sqi_update(hal_sqi_t *sqi, float raw)
+{
+    if (!sqi || sqi->fs <= 0.0f) {
+        return HAL_QUALITY_POOR;
+    }
+
+    /* DC level, AC before and after the pulse low-pass. Counts drop as blood
+     * volume rises, so the pulse is the negated AC. */
+    /* 1/n weights until the window has filled, so the start is a plain
+     * average instead of a decay from zero */
+    if ((float)sqi->seen * sqi->a_win < 1.0f) {
+        sqi->seen++;
+    }
+    const float n_inv = 1.0f / (float)sqi->seen;
+    sqi->dc += (n_inv > sqi->a_dc ? n_inv : sqi->a_dc) * (raw - sqi->dc);
+    const float ac = sqi->dc - raw;
+    sqi->lp += sqi->a_lp * (ac - sqi->lp);
+    const float y = sqi->lp;
+
+    const float a = n_inv > sqi->a_win ? n_inv : sqi->a_win;
+    sqi->m1 += a * (y - sqi->m1);
+    sqi->m2 += a * (y * y - sqi->m2);
+    sqi->m3 += a * (y * y * y - sqi->m3);
+    sqi->hp2 += a * (ac * ac - sqi->hp2);
+
+    const float mean = sqi->m1;
+    const float var = sqi->m2 - mean * mean;
+    if (!(var > 0.0f) || !(sqi->dc > 0.0f)) {
+        sqi->perfusion = sqi->skewness = sqi->regularity = sqi->concentration = 0.0f;
+        return 1;
+    }
+    const float rms = sqrtf(var);
+
+    const float pi = 2.0f * 1.41421356f * rms / sqi->dc;
+    sqi->perfusion = clamp01((pi - SQI_PI_MIN) / (SQI_PI_GOOD - SQI_PI_MIN));
+
+    const float m3c = sqi->m3 - 3.0f * mean * sqi->m2 + 2.0f * mean * mean * mean;
+    const float skew = m3c / (var * rms);
+    sqi->skewness = clamp01(0.5f + 0.5f * skew / SQI_SKEW_GOOD);
+
+    const float conc = sqi->hp2 > 0.0f ? var / sqi->hp2 : 0.0f;
+    sqi->concentration = clamp01((conc - SQI_CONC_MIN) / (1.0f - SQI_CONC_MIN));
+
+    update_crossings(sqi, y - mean, rms);
+
+    const float q = sqi->perfusion *
+                    (SQI_W_REGULARITY * sqi->regularity +
+                     SQI_W_CONCENTRATION * sqi->concentration +
+                     SQI_W_SKEWNESS * sqi->skewness);
+    int pct = (int)(100.0f * q + 0.5f);
+    return (hal_quality_t)(pct < 1 ? 1 : (pct > 100 ? 100 : pct));
+}
@@ -0,0 +1,109 @@
+/*
+ * CareLoop Hardware Abstraction Layer - Streaming Hampel Spike Filter
+ * Copyright (c) 2025
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HAL_HAMPEL_H
+#define HAL_HAMPEL_H
+
+#include "hal_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_HAMPEL_MIN_WINDOW   5
+#define HAL_HAMPEL_MAX_WINDOW   31
+/** MAD to standard deviation for Gaussian noise */
+#define HAL_HAMPEL_MAD_SCALE    1.4826f
+
+/**
+ * @brief Sliding median over the last `window` samples
+ *
+ * Two heaps of ring-slot indices, a max-heap for the lower half and a
+ * min-heap for the upper half, plus each slot's heap position. A new sample
+ * overwrites the oldest slot in place and is sifted within its heap, and at
+ * most one exchange of the two roots restores the split: O(log window) per
+ * sample, no allocation.
+ */
+typedef struct {
+    float val[HAL_HAMPEL_MAX_WINDOW];   /**< samples by ring slot */
+    uint8_t lo[HAL_HAMPEL_MAX_WINDOW];  /**< max-heap of slots, lower half */
+    uint8_t hi[HAL_HAMPEL_MAX_WINDOW];  /**< min-heap of slots, upper half */
+    uint8_t pos[HAL_HAMPEL_MAX_WINDOW]; /**< slot -> heap index (HI flag) */
+    uint8_t n_lo;
+    uint8_t n_hi;
+    uint8_t window;
+    uint8_t next;                       /**< slot the next sample overwrites */
+} hal_median_t;
+
+/**
+ * @brief Hampel filter for single-sample spikes
+ *
+ * Centered: the sample in the middle of the window (window / 2 samples
+ * old) is compared with the window median and replaced by it if the
+ * distance exceeds n_sigma robust standard deviations. On a smooth pulse the
+ * centered median follows ramps exactly, where a causal one would lag and
+ * flag every upstroke.
+ *
+ * The scale comes from the first differences: HAL_HAMPEL_MAD_SCALE *
+ * median(|x[i] - x[i-1]|) / sqrt(2) over the same window, a second sliding
+ * median that does not depend on the current one, so the whole filter stays
+ * O(log window) per sample. A spike moves two of the differences and
+ * neither median. min_dev floors the scale for quantized, nearly flat input.
+ * Nothing is replaced until the window is full; the window keeps the
+ * original samples.
+ */
+typedef struct {
+    hal_median_t values;
+    hal_median_t diffs;
+    float prev;                         /**< newest raw sample */
+    float n_sigma;
+    float min_dev;
+    uint32_t replaced;                  /**< since init */
+} hal_hampel_t;
+
+/**
+ * @brief Set the window (odd, clamped to HAL_HAMPEL_MIN/MAX_WINDOW) and clear
+ */
+void hal_median_init(hal_median_t *m, uint8_t window);
+
+/**
+ * @brief Forget the samples, keep the window
+ */
+void hal_median_reset(hal_median_t *m);
+
+/**
+ * @brief Add one sample (replacing the oldest once full)
+ * @return Median of the samples in the window
+ */
+float hal_median_push(hal_median_t *m, float x);
+
+/**
+ * @brief Configure and clear
+ * @param window Samples (odd, 5..31)
+ * @param n_sigma Threshold in robust standard deviations (3 is usual)
+ * @param min_dev Floor for the robust standard deviation, input units
+ */
+void hal_hampel_init(hal_hampel_t *h, uint8_t window, float n_sigma, float min_dev);
+
+/**
+ * @brief Forget the window (e.g. on contact loss), keep the settings and count
+ */
+void hal_hampel_reset(hal_hampel_t *h);
+
+/**
+ * @brief Push one raw sample, get the filtered one window / 2 samples back
+ * @param x In: newest raw sample. Out: the delayed sample, or the window
+ *          median if it was an outlier (the first one repeats until
+ *          window / 2 samples have arrived)
+ * @return true if the sample returned in *x has been replaced
+ */
+bool hal_hampel_update(hal_hampel_t *h, float *x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_HAMPEL_H */
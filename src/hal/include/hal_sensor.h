@@ -9,6 +9,10 @@
 
 #include "hal_common.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef enum {
     HAL_SENSOR_TYPE_HEART_RATE = 0,
     HAL_SENSOR_TYPE_SPO2,
@@ -21,7 +25,8 @@ typedef struct {
     hal_timestamp_t timestamp; 
     float value;               /**< Sensor value (units depend on type) */
     uint32_t raw_value;        
-    /* Optional vector components for multi-axis sensors (set when relevant) */
+    /* Optional vector components for multi-axis sensors (set when relevant).
+     * PPG sensors: x = red counts, y = IR counts (0 without an IR slot) */
     float x;
     float y;
     float z;
@@ -41,6 +46,7 @@ typedef struct {
     uint32_t total_samples;       /**< Total samples taken */
     uint32_t valid_samples;       /**< Valid samples count */
     uint32_t error_count;         /**< Error count */
+    uint32_t replaced_samples;    /**< Samples replaced by the spike filter */
     hal_quality_t avg_quality;   /**< Average signal quality */
     hal_timestamp_t last_reading; /**< Timestamp of last reading */
 } hal_sensor_stats_t;
@@ -152,4 +158,8 @@ static inline uint32_t hal_sensor_get_sample_rate(const hal_sensor_t *sensor)
     return cfg.sample_rate_hz;
 }
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* HAL_SENSOR_H */
@@ -0,0 +1,82 @@
+/*
+ * CareLoop Hardware Abstraction Layer - PPG Signal Quality Index
+ * Copyright (c) 2025
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HAL_SQI_H
+#define HAL_SQI_H
+
+#include "hal_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Streaming PPG signal quality index
+ *
+ * Four components over an exponential window of HAL_SQI_WINDOW_S, each
+ * updated in O(1) per raw sample:
+ *  - perfusion: pulsatile RMS relative to the DC level;
+ *  - skewness of the pulse (a PPG pulse is strongly skewed, noise and
+ *    motion much less so);
+ *  - regularity of the intervals between zero crossings (with hysteresis)
+ *    of the pulse, which must also fall in the cardiac range;
+ *  - concentration: share of the AC power left below HAL_SQI_PULSE_HZ.
+ *
+ * The quality is perfusion-gated: perfusion * weighted sum of the others,
+ * scaled to 1..100 (0 stays reserved for HAL_QUALITY_INVALID).
+ */
+#define HAL_SQI_WINDOW_S        4.0f
+#define HAL_SQI_DC_TAU_S        1.5f
+#define HAL_SQI_PULSE_HZ        4.0f
+
+typedef struct {
+    /* Coefficients (from the sample rate) */
+    float fs;
+    float a_dc;             /**< DC low-pass */
+    float a_lp;             /**< pulse low-pass */
+    float a_win;            /**< window EMA */
+
+    /* Filter and window state */
+    float dc;
+    float lp;
+    float m1, m2, m3;       /**< raw moments of the pulse */
+    float hp2;              /**< AC power before the pulse low-pass */
+    int8_t zc_armed;        /**< pulse went below -hysteresis */
+    uint32_t since_zc;      /**< samples since the last rising crossing */
+    float zc_mean;          /**< crossing interval, samples */
+    float zc_dev;           /**< mean absolute deviation of the interval */
+    uint32_t seen;
+
+    /* Latest components, 0..1 */
+    float perfusion;
+    float skewness;
+    float regularity;
+    float concentration;
+} hal_sqi_t;
+
+/**
+ * @brief Set the sample rate and reset the state
+ * @param sqi SQI instance
+ * @param fs_hz Rate of the samples passed to hal_sqi_update()
+ */
+void hal_sqi_init(hal_sqi_t *sqi, uint32_t fs_hz);
+
+/**
+ * @brief Forget the window (e.g. on contact loss), keep the rate
+ */
+void hal_sqi_reset(hal_sqi_t *sqi);
+
+/**
+ * @brief Feed one raw PPG sample
+ * @return Quality 1..100 of the window ending at this sample
+ */
+hal_quality_t hal_sqi_update(hal_sqi_t *sqi, float raw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_SQI_H */
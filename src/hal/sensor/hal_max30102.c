@@ -1,4 +1,6 @@
 #include "hal_sensor.h"
+#include "hal_sqi.h"
+#include "hal_hampel.h"
 #include "max30102.h"
 #include <zephyr/device.h>
 #include <zephyr/drivers/sensor.h>
@@ -17,6 +19,13 @@ typedef struct {
     hal_sensor_stats_t stats;
     bool calibrated;
     uint32_t baseline_value;
+    hal_sqi_t sqi;
+#ifdef CONFIG_MAX30102_SPIKE_FILTER
+    hal_hampel_t spike_red;
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    hal_hampel_t spike_ir;
+#endif
+#endif
 } max30102_priv_t;
 
 /* Private data instance */
@@ -31,6 +40,26 @@ static const hal_sensor_config_t default_config = {
     .auto_calibrate = true
 };
 
+/* Spike threshold in robust standard deviations, and its floor in counts
+ * (ADC quantization on a flat signal) */
+#define SPIKE_N_SIGMA   3.0f
+#define SPIKE_MIN_DEV   16.0f
+
+/**
+ * @brief (Re)start the spike filters for the configured window
+ */
+static void spike_filter_init(void)
+{
+#ifdef CONFIG_MAX30102_SPIKE_FILTER
+    hal_hampel_init(&max30102_priv.spike_red, CONFIG_MAX30102_SPIKE_WINDOW,
+                    SPIKE_N_SIGMA, SPIKE_MIN_DEV);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    hal_hampel_init(&max30102_priv.spike_ir, CONFIG_MAX30102_SPIKE_WINDOW,
+                    SPIKE_N_SIGMA, SPIKE_MIN_DEV);
+#endif
+#endif
+}
+
 /**
  * @brief Initialize MAX30102 sensor
  */
@@ -80,6 +109,8 @@ static hal_error_t max30102_hal_init(void)
     
     /* Reset statistics */
     memset(&max30102_priv.stats, 0, sizeof(max30102_priv.stats));
+    hal_sqi_init(&max30102_priv.sqi, max30102_priv.config.sample_rate_hz);
+    spike_filter_init();
     
     /* Initialize calibration state */
     max30102_priv.calibrated = false;
@@ -90,24 +121,50 @@ static hal_error_t max30102_hal_init(void)
 }
 
 /**
- * @brief Calculate signal quality based on raw value
+ * @brief Contact and saturation check on the raw level alone
  */
-static hal_quality_t calculate_quality(uint32_t raw_value)
+static hal_quality_t level_quality(uint32_t raw_value)
 {
-    /* Quality assessment based on signal strength */
     if (raw_value < 5000) {
         return HAL_QUALITY_INVALID;  /* No finger detected */
     } else if (raw_value > 250000) {
         return HAL_QUALITY_POOR;     /* Signal saturation */
-    } else if (raw_value < 15000) {
-        return HAL_QUALITY_POOR;     /* Weak signal */
-    } else if (raw_value < 20000) {
-        return HAL_QUALITY_FAIR;     /* Marginal signal */
-    } else if (raw_value > 200000) {
-        return HAL_QUALITY_FAIR;     /* High signal */
-    } else {
-        return HAL_QUALITY_EXCELLENT; /* Good signal range */
     }
+    return HAL_QUALITY_EXCELLENT;
+}
+
+#ifdef CONFIG_MAX30102_SPIKE_FILTER
+/**
+ * @brief Replace a single-sample spike (I2C glitch, ambient flash) by the
+ * window median before it reaches the band-pass, where it would ring for
+ * seconds. The output lags by CONFIG_MAX30102_SPIKE_WINDOW / 2 samples.
+ */
+static uint32_t reject_spike(hal_hampel_t *h, int32_t raw)
+{
+    float x = (float)(raw > 0 ? raw : 0);
+    if (hal_hampel_update(h, &x)) {
+        max30102_priv.stats.replaced_samples++;
+    }
+    /* Contact lost: start over on the next contact level */
+    if (level_quality((uint32_t)x) == HAL_QUALITY_INVALID) {
+        hal_hampel_reset(h);
+    }
+    return (uint32_t)x;
+}
+#endif
+
+/**
+ * @brief Calculate signal quality: streaming SQI, capped by the level check
+ */
+static hal_quality_t calculate_quality(uint32_t raw_value)
+{
+    hal_quality_t level = level_quality(raw_value);
+    if (level == HAL_QUALITY_INVALID) {
+        hal_sqi_reset(&max30102_priv.sqi);  /* start over on new contact */
+        return level;
+    }
+    hal_quality_t sqi = hal_sqi_update(&max30102_priv.sqi, (float)raw_value);
+    return sqi < level ? sqi : level;
 }
 
 /**
@@ -126,6 +183,9 @@ static hal_error_t max30102_hal_read(hal_sensor_reading_t *reading)
     }
     
     struct sensor_value red_val;
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    struct sensor_value ir_val;
+#endif
     int ret;
     
     /* Update statistics */
@@ -148,7 +208,25 @@ static hal_error_t max30102_hal_read(hal_sensor_reading_t *reading)
         reading->error_code = HAL_ERROR_HARDWARE;
         return HAL_ERROR_HARDWARE;
     }
+
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    /* IR slot of the same FIFO sample (SpO2 mode) */
+    ret = sensor_channel_get(max30102_priv.dev, SENSOR_CHAN_IR, &ir_val);
+    if (ret) {
+        LOG_ERR("Failed to get IR channel: %d", ret);
+        max30102_priv.stats.error_count++;
+        reading->error_code = HAL_ERROR_HARDWARE;
+        return HAL_ERROR_HARDWARE;
+    }
+#endif
     
+#ifdef CONFIG_MAX30102_SPIKE_FILTER
+    red_val.val1 = (int32_t)reject_spike(&max30102_priv.spike_red, red_val.val1);
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    ir_val.val1 = (int32_t)reject_spike(&max30102_priv.spike_ir, ir_val.val1);
+#endif
+#endif
+
     /* Fill reading structure */
     reading->timestamp = hal_get_timestamp();
     reading->raw_value = red_val.val1;
@@ -157,8 +235,17 @@ static hal_error_t max30102_hal_read(hal_sensor_reading_t *reading)
     
     /* Convert raw value to meaningful units (placeholder for now) */
     reading->value = (float)reading->raw_value;
-    reading->x = 0.0f;
+    reading->x = (float)red_val.val1;
+#ifdef CONFIG_MAX30102_SPO2_MODE
+    reading->y = (float)ir_val.val1;
+    /* SpO2 needs contact on both channels; the SQI runs on red */
+    hal_quality_t ir_quality = level_quality((uint32_t)ir_val.val1);
+    if (ir_quality < reading->quality) {
+        reading->quality = ir_quality;
+    }
+#else
     reading->y = 0.0f;
+#endif
     reading->z = 0.0f;
     
     /* Update statistics */
@@ -194,6 +281,8 @@ static hal_error_t max30102_hal_configure(const hal_sensor_config_t *config)
     
     /* Store configuration */
     max30102_priv.config = *config;
+    hal_sqi_init(&max30102_priv.sqi, config->sample_rate_hz);
+    spike_filter_init();
 
     /* Attempt to push to driver */
     struct sensor_value sval;
@@ -231,7 +320,8 @@ static hal_error_t max30102_hal_calibrate(void)
         hal_sensor_reading_t reading;
         hal_error_t ret = max30102_hal_read(&reading);
         
-        if (ret == HAL_OK && reading.quality > HAL_QUALITY_POOR) {
+        /* The SQI needs seconds of pulse at the full rate: contact is enough */
+        if (ret == HAL_OK && reading.quality != HAL_QUALITY_INVALID) {
             baseline_sum += reading.raw_value;
             valid_readings++;
         }
@@ -91,18 +91,19 @@ static hal_error_t mpu6050_accel_read(hal_sensor_reading_t *reading) {
         mpu_priv.accel_stats.error_count++;
         return HAL_ERROR_HARDWARE;
     }
-    /* Fill vector and magnitude (units per Zephyr driver scaling) */
-    int32_t x = accel[0].val1;
-    int32_t y = accel[1].val1;
-    int32_t z = accel[2].val1;
-    float mag = sqrtf((float)(x*x + y*y + z*z));
+    /* Fill vector and magnitude (m/s^2, full driver resolution: the motion
+     * canceller needs more than the integer part) */
+    float x = (float)sensor_value_to_double(&accel[0]);
+    float y = (float)sensor_value_to_double(&accel[1]);
+    float z = (float)sensor_value_to_double(&accel[2]);
+    float mag = sqrtf(x*x + y*y + z*z);
 
     reading->timestamp = hal_get_timestamp();
     reading->value = mag; /* magnitude */
-    reading->x = (float)x;
-    reading->y = (float)y;
-    reading->z = (float)z;
-    reading->raw_value = (uint32_t)(x & 0xFFFFFFFF); /* legacy */
+    reading->x = x;
+    reading->y = y;
+    reading->z = z;
+    reading->raw_value = (uint32_t)(accel[0].val1 & 0xFFFFFFFF); /* legacy */
     reading->quality = calc_quality(true);
     reading->error_code = HAL_OK;
 
@@ -149,17 +150,17 @@ static hal_error_t mpu6050_gyro_read(hal_sensor_reading_t *reading) {
         mpu_priv.gyro_stats.error_count++;
         return HAL_ERROR_HARDWARE;
     }
-    int32_t x = gyro[0].val1;
-    int32_t y = gyro[1].val1;
-    int32_t z = gyro[2].val1;
-    float mag = sqrtf((float)(x*x + y*y + z*z));
+    float x = (float)sensor_value_to_double(&gyro[0]);
+    float y = (float)sensor_value_to_double(&gyro[1]);
+    float z = (float)sensor_value_to_double(&gyro[2]);
+    float mag = sqrtf(x*x + y*y + z*z);
 
     reading->timestamp = hal_get_timestamp();
     reading->value = mag; /* magnitude */
-    reading->x = (float)x;
-    reading->y = (float)y;
-    reading->z = (float)z;
-    reading->raw_value = (uint32_t)(x & 0xFFFFFFFF);
+    reading->x = x;
+    reading->y = y;
+    reading->z = z;
+    reading->raw_value = (uint32_t)(gyro[0].val1 & 0xFFFFFFFF);
     reading->quality = calc_quality(true);
     reading->error_code = HAL_OK;
 
@@ -8,6 +8,7 @@
 #include <zephyr/logging/log.h>
 #include <stdlib.h>
 #include "hal_sensor.h"
+#include "heart_rate.h"
 
 /* Device-specific HAL adapters register via hal_sensor_system_init() */
 
@@ -37,6 +38,7 @@ int main(void)
     hal_sensor_t *hr_sensor;
     hal_sensor_t *accel_sensor;
     hal_sensor_t *gyro_sensor;
+    hal_sensor_t *spo2_sensor;
     hal_sensor_reading_t reading;
     
     /* Initialize sensor subsystem (register + init) */
@@ -58,15 +60,45 @@ int main(void)
         LOG_WRN("ACCEL or GYRO sensors not available");
     }
     
+    /* Accelerometer as motion reference for the PPG (optional). The HR
+     * thread then samples the MPU6050; accel and gyro share the device, so
+     * stop polling both from here. */
+    if (accel_sensor) {
+        if (heart_rate_set_motion_sensor(accel_sensor)) {
+            accel_sensor = NULL;
+            gyro_sensor = NULL;
+        } else {
+            LOG_INF("HR motion cancelling disabled");
+        }
+    }
+
+    /* The HR thread owns the PPG sensor from here on */
+    if (!heart_rate_start(hr_sensor)) {
+        LOG_ERR("Heart rate processing failed to start");
+        return -1;
+    }
+
     LOG_INF("Heart rate sensor ready");
+
+    /* heart_rate_start() registered it above when the PPG runs in SpO2
+     * mode, so it is there (or not) already */
+    spo2_sensor = hal_sensor_get(HAL_SENSOR_TYPE_SPO2);
     
     /* Main reading loop */
     while (1) {
-        ret = hr_sensor->ops->read(&reading);
-        if (ret == HAL_OK) {
-            if (reading.quality >= HAL_QUALITY_FAIR) {
-                LOG_INF("HR: %d (Q:%d%%)", reading.raw_value, reading.quality);
-            }
+        float bpm;
+        if (heart_rate_get_bpm(&bpm)) {
+            LOG_INF("HR: %d BPM", (int)(bpm + 0.5f));
+        } else if (heart_rate_get_state() == HR_STATE_NO_CONTACT) {
+            LOG_INF("HR: no contact");
+        } else if (heart_rate_get_state() == HR_STATE_MOTION) {
+            LOG_INF("HR: paused, heavy motion");
+        }
+        if (spo2_sensor && spo2_sensor->ops->read(&reading) == HAL_OK) {
+            LOG_INF("SpO2: %d %%", (int)reading.raw_value);
+        }
+        if (heart_rate_get_respiration(&bpm)) {
+            LOG_INF("Resp: %d br/min", (int)(bpm + 0.5f));
         }
         if (accel_sensor && accel_sensor->ops->read) {
             if (accel_sensor->ops->read(&reading) == HAL_OK) {
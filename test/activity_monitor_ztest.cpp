@@ -0,0 +1,128 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "activity_monitor.h"
+
+static constexpr uint32_t FS = 50;
+static constexpr size_t BLOCK = 10;
+
+/* |a| on the wrist: gravity plus step-rate oscillation of amplitude amp */
+struct MagSynth {
+    float amp = 0.0f;
+    float step_hz = 1.8f;
+    float t = 0.0f;
+
+    float next()
+    {
+        const float p = 2.0f * 3.14159265f * step_hz * t;
+        t += 1.0f / (float)FS;
+        return 9.81f + amp * (sinf(p) + 0.5f * sinf(2.0f * p + 0.3f));
+    }
+};
+
+/* Feed `seconds`; returns the number of mode changes seen at block edges */
+static int run(ActivityMonitor& a, MagSynth& m, float seconds)
+{
+    int changes = 0;
+    HrMode prev = a.mode();
+    for (size_t off = 0; off < (size_t)(seconds * FS); off += BLOCK) {
+        float buf[BLOCK];
+        for (auto &v : buf) v = m.next();
+        HrMode now = a.update(buf, BLOCK);
+        if (now != prev) ++changes;
+        prev = now;
+    }
+    return changes;
+}
+
+ZTEST_SUITE(activity_monitor, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(activity_monitor, test_still_stays_full)
+{
+    ActivityMonitor a;
+    a.init(FS);
+    MagSynth m;
+    m.amp = 0.05f;
+    zassert_equal(run(a, m, 20.0f), 0, "mode changed at rest");
+    zassert_true(a.mode() == HrMode::Full, "not Full at rest");
+    zassert_true(a.level() < 0.1f, "rest level %d mm/s^2", (int)(a.level() * 1000.0f));
+}
+
+ZTEST(activity_monitor, test_walking_reduces_running_suspends)
+{
+    ActivityMonitor a;
+    a.init(FS);
+    MagSynth m;
+    m.amp = 2.0f;
+    run(a, m, 1.5f);
+    zassert_true(a.mode() == HrMode::Reduced, "walking: mode %d", (int)a.mode());
+
+    m.amp = 8.0f;
+    run(a, m, 1.5f);
+    zassert_true(a.mode() == HrMode::Suspended, "running: mode %d", (int)a.mode());
+}
+
+ZTEST(activity_monitor, test_recovers_after_hold)
+{
+    ActivityMonitor a;
+    a.init(FS);
+    MagSynth m;
+    m.amp = 8.0f;
+    run(a, m, 5.0f);
+    zassert_true(a.mode() == HrMode::Suspended, "not suspended");
+
+    m.amp = 0.0f;
+    run(a, m, ActivityMonitor::HOLD_S - 0.5f);
+    zassert_true(a.mode() == HrMode::Suspended, "left Suspended before HOLD_S");
+    run(a, m, 4.0f);
+    zassert_true(a.mode() == HrMode::Full, "still mode %d after stopping", (int)a.mode());
+}
+
+ZTEST(activity_monitor, test_hysteresis_band_does_not_chatter)
+{
+    /* A level between REDUCED_OFF and REDUCED_ON keeps whatever mode
+     * was active when it was reached */
+    ActivityMonitor a;
+    a.init(FS);
+    MagSynth m;
+    m.amp = 2.0f;
+    run(a, m, 5.0f);
+    m.amp = 1.35f;
+    run(a, m, 2.0f);
+    float level = a.level();
+    zassert_true(level > ActivityMonitor::REDUCED_OFF && level < ActivityMonitor::REDUCED_ON,
+                 "level %d mm/s^2 outside the band", (int)(level * 1000.0f));
+    zassert_equal(run(a, m, 20.0f), 0, "chattered in the hysteresis band");
+    zassert_true(a.mode() == HrMode::Reduced, "dropped out of Reduced");
+
+    ActivityMonitor b;
+    b.init(FS);
+    MagSynth calm;
+    calm.amp = 1.35f;
+    zassert_equal(run(b, calm, 20.0f), 0, "chattered from Full");
+    zassert_true(b.mode() == HrMode::Full, "left Full inside the band");
+}
+
+ZTEST(activity_monitor, test_time_split)
+{
+    ActivityMonitor a;
+    a.init(FS);
+    MagSynth m;
+    run(a, m, 10.0f);
+    m.amp = 2.0f;
+    run(a, m, 10.0f);
+    m.amp = 8.0f;
+    run(a, m, 10.0f);
+
+    uint32_t full = a.samplesIn(HrMode::Full);
+    uint32_t reduced = a.samplesIn(HrMode::Reduced);
+    uint32_t suspended = a.samplesIn(HrMode::Suspended);
+    TC_PRINT("time split: full %u, reduced %u, suspended %u samples\n",
+             full, reduced, suspended);
+    zassert_equal(full + reduced + suspended, 30u * FS, "samples lost from the split");
+    zassert_within((float)full, 10.0f * FS, 1.0f * FS, "full time off");
+    zassert_within((float)suspended, 10.0f * FS, 1.0f * FS, "suspended time off");
+
+    a.clearStats();
+    zassert_equal(a.samplesIn(HrMode::Suspended), 0u, "stats not cleared");
+}
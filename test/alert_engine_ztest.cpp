@@ -0,0 +1,127 @@
+#include <zephyr/ztest.h>
+
+#include "alert_engine.h"
+
+static constexpr uint32_t STEP_MS = 200;   /* one reading per HR block */
+
+static AlertRule hr_above(uint8_t id, int16_t bpm_x10, uint8_t seconds, uint16_t hyst_x10)
+{
+    return AlertRule{ id, (uint8_t)Vital::HeartRate, 0, seconds, bpm_x10, hyst_x10 };
+}
+
+ZTEST_SUITE(alert_engine, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(alert_engine, test_fires_after_duration)
+{
+    AlertEngine<8> e;
+    zassert_true(e.setRule(0, hr_above(7, 1200, 10, 50)), "rule rejected");
+
+    /* 120 BPM exactly is not above; 9.8 s above is not long enough */
+    uint32_t t = 0;
+    zassert_equal(e.update(Vital::HeartRate, true, 1200, t), 0, "fired at the threshold");
+    for (int i = 0; i < 50; ++i) {
+        t += STEP_MS;
+        zassert_equal(e.update(Vital::HeartRate, true, 1300, t), 0, "fired after %u ms", t);
+    }
+    /* A dip restarts the run */
+    t += STEP_MS;
+    zassert_equal(e.update(Vital::HeartRate, true, 1100, t), 0, "fired on a dip");
+    const uint32_t start = t + STEP_MS;
+    uint32_t fired_at = 0;
+    Alert a[8];
+    size_t n = 0;
+    for (int i = 0; i < 60 && !fired_at; ++i) {
+        t += STEP_MS;
+        if (e.update(Vital::HeartRate, true, 1300, t, a, &n)) {
+            fired_at = t;
+        }
+    }
+    zassert_equal(fired_at - start, 10000, "fired after %u ms", fired_at - start);
+    zassert_equal(n, 1, "%u alerts", (unsigned)n);
+    zassert_true(a[0].id == 7 && a[0].vital == (uint8_t)Vital::HeartRate && a[0].value == 1300,
+                 "alert %u/%u/%d", a[0].id, a[0].vital, a[0].value);
+    zassert_equal(e.latched(), 0x1, "latched 0x%x", e.latched());
+
+    /* Other vitals do not step it */
+    zassert_equal(e.update(Vital::Spo2, true, 1300, t), 0, "SpO2 reading raised an HR alert");
+}
+
+ZTEST(alert_engine, test_hysteresis_and_acknowledge)
+{
+    AlertEngine<8> e;
+    /* SpO2 < 90 % for 3 readings, released above 92 % */
+    zassert_true(e.setRule(2, AlertRule{ 1, (uint8_t)Vital::Spo2,
+                                         AlertRule::BELOW | AlertRule::SAMPLES, 3, 900, 20 }),
+                 "rule rejected");
+    uint32_t t = 0;
+    uint32_t raised = 0;
+    const int32_t readings[] = { 880, 885, 870 };
+    for (int32_t v : readings) raised |= e.update(Vital::Spo2, true, v, t += STEP_MS);
+    zassert_equal(raised, 1u << 2, "raised 0x%x", raised);
+    zassert_equal(e.active(), 1u << 2, "not active");
+
+    /* Inside the hysteresis band: stays active, does not fire again */
+    const int32_t wobble[] = { 905, 915, 880, 870, 860, 910 };
+    for (int32_t v : wobble) {
+        zassert_equal(e.update(Vital::Spo2, true, v, t += STEP_MS), 0, "refired at %d", v);
+    }
+    zassert_equal(e.active(), 1u << 2, "released inside the band");
+
+    e.acknowledge();
+    zassert_equal(e.latched(), 0, "acknowledge kept the alert");
+    zassert_equal(e.active(), 1u << 2, "acknowledge released the rule");
+
+    /* Past the band: released, and the next drop raises it again */
+    e.update(Vital::Spo2, true, 925, t += STEP_MS);
+    zassert_equal(e.active(), 0, "not released above 92 %%");
+    raised = 0;
+    for (int32_t v : readings) raised |= e.update(Vital::Spo2, true, v, t += STEP_MS);
+    zassert_equal(raised, 1u << 2, "not raised again");
+}
+
+ZTEST(alert_engine, test_missing_readings_restart_the_run)
+{
+    AlertEngine<4> e;
+    zassert_true(e.setRule(0, AlertRule{ 3, (uint8_t)Vital::Respiration,
+                                         AlertRule::SAMPLES, 4, 300, 20 }), "rule rejected");
+    uint32_t t = 0;
+    for (int i = 0; i < 3; ++i) e.update(Vital::Respiration, true, 320, t += STEP_MS);
+    e.update(Vital::Respiration, false, 0, t += STEP_MS);
+    for (int i = 0; i < 3; ++i) {
+        zassert_equal(e.update(Vital::Respiration, true, 320, t += STEP_MS), 0,
+                      "run survived a gap");
+    }
+    zassert_equal(e.update(Vital::Respiration, true, 320, t += STEP_MS), 1, "not raised");
+    /* An active rule survives a gap */
+    e.update(Vital::Respiration, false, 0, t += STEP_MS);
+    zassert_equal(e.active(), 1, "gap released the rule");
+}
+
+ZTEST(alert_engine, test_table_updates)
+{
+    AlertEngine<4> e;
+    zassert_false(e.setRule(4, hr_above(1, 1000, 0, 0)), "slot out of range");
+    AlertRule bad = hr_above(1, 1000, 0, 0);
+    bad.vital = (uint8_t)Vital::Count;
+    zassert_false(e.setRule(0, bad), "unknown vital accepted");
+    bad = hr_above(1, 1000, 0, 0);
+    bad.flags = 0x80;
+    zassert_false(e.setRule(0, bad), "unknown flag accepted");
+
+    /* Zero duration: the first reading past the threshold raises it */
+    zassert_true(e.setRule(1, hr_above(9, 1000, 0, 0)), "rule rejected");
+    zassert_equal(e.update(Vital::HeartRate, true, 1010, 0), 1u << 1, "not raised");
+
+    /* Replacing a rule drops its state and latched alert */
+    zassert_true(e.setRule(1, AlertRule{ 9, (uint8_t)Vital::Spo2, AlertRule::BELOW, 0, 900, 0 }),
+                 "rule rejected");
+    zassert_true(e.latched() == 0 && e.active() == 0, "old state kept");
+    zassert_equal(e.update(Vital::HeartRate, true, 1010, 0), 0, "old vital still watched");
+    zassert_equal(e.update(Vital::Spo2, true, 850, 0), 1u << 1, "new vital not watched");
+
+    AlertRule r;
+    zassert_true(e.rule(1, r) && r.vital == (uint8_t)Vital::Spo2 && r.threshold == 900,
+                 "rule not stored");
+    zassert_true(e.setRule(1, AlertRule{}), "empty rule rejected");
+    zassert_equal(e.update(Vital::Spo2, true, 850, 0), 0, "empty slot fired");
+}
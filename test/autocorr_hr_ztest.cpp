@@ -0,0 +1,114 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "autocorr_hr.h"
+#include "beat_detector.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr size_t BLOCK = 10;
+
+static void start(PpgSynth& ppg, HrFilter& f, AutocorrHr& a, uint32_t fs)
+{
+    ppg.fs = (float)fs;
+    zassert_true(f.init(fs, ppg.dc), "no band-pass for %u Hz", fs);
+    zassert_true(a.init(fs), "autocorrelation init failed at %u Hz", fs);
+}
+
+static void run(PpgSynth& ppg, HrFilter& f, AutocorrHr& a, float seconds,
+                BeatDetector* d = nullptr)
+{
+    float buf[BLOCK];
+    size_t total = (size_t)(seconds * ppg.fs);
+    for (size_t off = 0; off < total; off += BLOCK) {
+        ppg.fill(buf, BLOCK);
+        f.process(buf, buf, BLOCK);
+        a.process(buf, BLOCK);
+        if (d) d->process(buf, BLOCK);
+    }
+}
+
+ZTEST_SUITE(autocorr_hr, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(autocorr_hr, test_lag_range)
+{
+    AutocorrHr a;
+    zassert_true(a.init(50), "50 Hz rejected");
+    zassert_equal(a.lagMin(), 13u, "220 BPM lag at 50 Hz");
+    zassert_equal(a.lagMax(), 100u, "30 BPM lag at 50 Hz");
+    zassert_true(a.init(100), "100 Hz rejected");
+    zassert_false(a.init(200), "200 Hz lags exceed LAG_MAX");
+
+    /* Not valid until the longest lag plus one time constant is covered */
+    a.init(50);
+    float x[10] = { 1.0f };
+    a.process(x, 10);
+    AutocorrHr::Estimate e;
+    zassert_false(a.estimate(e), "estimate before warm-up");
+}
+
+ZTEST(autocorr_hr, test_bpm_40_to_200)
+{
+    const float rates[] = { 40, 60, 75, 90, 120, 150, 180, 200 };
+    const uint32_t fs_list[] = { 25, 50, 100 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            PpgSynth ppg;
+            ppg.bpm = bpm;
+            HrFilter f;
+            AutocorrHr a;
+            start(ppg, f, a, fs);
+            run(ppg, f, a, 15.0f);
+
+            AutocorrHr::Estimate e;
+            zassert_true(a.estimate(e), "%u Hz, %d BPM: no estimate", fs, (int)bpm);
+            /* One lag step at 200 BPM and 25 Hz is ~25 BPM; interpolation
+             * must bring it well inside that */
+            zassert_within(e.bpm, bpm, 0.02f * bpm + 1.0f, "%u Hz: %d BPM estimated as %d",
+                           fs, (int)bpm, (int)e.bpm);
+            zassert_true(e.score > 0.7f, "%u Hz, %d BPM: score %d%%",
+                         fs, (int)bpm, (int)(e.score * 100.0f));
+        }
+    }
+}
+
+ZTEST(autocorr_hr, test_low_perfusion)
+{
+    /* Weak pulse in broadband noise: single peaks are unreliable, the
+     * periodicity is not */
+    PpgSynth ppg;
+    ppg.bpm = 66.0f;
+    ppg.ac = 150.0f;
+    ppg.noise = 100.0f;
+    HrFilter f;
+    AutocorrHr a;
+    BeatDetector d;
+    start(ppg, f, a, 50);
+    d.init(50);
+    run(ppg, f, a, 30.0f, &d);
+
+    AutocorrHr::Estimate e;
+    zassert_true(a.estimate(e), "no estimate");
+    zassert_within(e.bpm, 66.0f, 3.0f, "estimated %d BPM", (int)e.bpm);
+
+    float peaks_bpm = 0.0f;
+    bool peaks_ok = d.bpm(peaks_bpm) && fabsf(peaks_bpm - 66.0f) < 3.0f;
+    TC_PRINT("low perfusion: autocorr %d BPM (score %d%%), peaks %s\n",
+             (int)e.bpm, (int)(e.score * 100.0f), peaks_ok ? "ok" : "lost");
+}
+
+ZTEST(autocorr_hr, test_noise_scores_low)
+{
+    PpgSynth ppg;
+    ppg.ac = 0.0f;
+    ppg.noise = 1000.0f;
+    HrFilter f;
+    AutocorrHr a;
+    start(ppg, f, a, 50);
+    run(ppg, f, a, 20.0f);
+
+    AutocorrHr::Estimate e;
+    if (a.estimate(e)) {
+        zassert_true(e.score < 0.4f, "white noise score %d%%", (int)(e.score * 100.0f));
+    }
+}
@@ -0,0 +1,162 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "beat_detector.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr size_t BLOCK = 10;       /* 200 ms per wake-up @ 50 Hz */
+
+/* Run `seconds` of synthetic PPG through band-pass + detector in blocks */
+static void run_pipeline(PpgSynth& ppg, HrFilter& f, BeatDetector& d,
+                         float seconds, size_t block = BLOCK)
+{
+    float buf[64];
+    size_t total = (size_t)(seconds * ppg.fs);
+    for (size_t off = 0; off < total; off += block) {
+        size_t n = (total - off < block) ? total - off : block;
+        ppg.fill(buf, n);
+        f.process(buf, buf, n);
+        d.process(buf, n);
+    }
+}
+
+static void start(PpgSynth& ppg, HrFilter& f, BeatDetector& d, uint32_t fs)
+{
+    ppg.fs = (float)fs;
+    PpgSynth probe = ppg;
+    zassert_true(f.init(fs, probe.next()), "no table for %u Hz", fs);
+    d.init(fs);
+}
+
+ZTEST_SUITE(beat_detector, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(beat_detector, test_bpm_40_to_200)
+{
+    const float rates[] = { 40, 50, 60, 75, 90, 120, 150, 180, 200 };
+    const uint32_t fs_list[] = { 50, 100 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            PpgSynth ppg;
+            ppg.bpm = bpm;
+            HrFilter f;
+            BeatDetector d;
+            start(ppg, f, d, fs);
+            run_pipeline(ppg, f, d, 20.0f);
+
+            float est = 0.0f;
+            zassert_true(d.bpm(est), "%u Hz, %d BPM: no estimate", fs, (int)bpm);
+            zassert_within(est, bpm, 0.02f * bpm, "%u Hz: %d BPM estimated as %d.%01d",
+                           fs, (int)bpm, (int)est, (int)(est * 10.0f) % 10);
+
+            /* One detection per beat: no dicrotic double counts, no misses */
+            int expected = (int)(20.0f * bpm / 60.0f);
+            int got = (int)d.beats();
+            zassert_true(got >= expected - 1 && got <= expected + 1,
+                         "%u Hz, %d BPM: %d beats, expected %d", fs, (int)bpm, got, expected);
+        }
+    }
+}
+
+ZTEST(beat_detector, test_rr_ring)
+{
+    PpgSynth ppg;
+    ppg.bpm = 75.0f;
+    HrFilter f;
+    BeatDetector d;
+    start(ppg, f, d, 50);
+    run_pipeline(ppg, f, d, 30.0f);
+
+    zassert_equal(d.rrCount(), BeatDetector::RR_RING, "ring not full: %u", (unsigned)d.rrCount());
+    for (size_t i = 0; i < d.rrCount(); ++i) {
+        zassert_within(d.rr(i), 800, 20, "RR[%u] = %u ms", (unsigned)i, d.rr(i));
+    }
+    zassert_equal(d.rr(BeatDetector::RR_RING), 0, "out-of-range RR not 0");
+    zassert_equal(d.runLength(), BeatDetector::RR_RING, "run broken: %u",
+                  (unsigned)d.runLength());
+
+    /* The interval counter survives a restart, the run does not */
+    const uint32_t total = d.intervals();
+    zassert_true(total >= 35, "only %u intervals in 30 s", total);
+    d.reset();
+    zassert_equal(d.intervals(), total, "interval counter went back");
+    zassert_equal(d.runLength(), 0u, "run kept over reset");
+}
+
+ZTEST(beat_detector, test_noise_and_respiration)
+{
+    PpgSynth ppg;
+    ppg.bpm = 72.0f;
+    ppg.resp_hz = 0.25f;
+    ppg.resp_depth = 0.3f;
+    ppg.noise = 50.0f;
+    HrFilter f;
+    BeatDetector d;
+    start(ppg, f, d, 50);
+    run_pipeline(ppg, f, d, 30.0f);
+
+    float est = 0.0f;
+    zassert_true(d.bpm(est), "no estimate");
+    zassert_within(est, 72.0f, 2.0f, "estimated %d BPM", (int)est);
+}
+
+ZTEST(beat_detector, test_block_size_invariant)
+{
+    PpgSynth a, b;
+    a.bpm = b.bpm = 90.0f;
+    HrFilter fa, fb;
+    BeatDetector da, db;
+    start(a, fa, da, 50);
+    start(b, fb, db, 50);
+    run_pipeline(a, fa, da, 15.0f, 1);
+    run_pipeline(b, fb, db, 15.0f, 37);
+
+    zassert_equal(da.beats(), db.beats(), "beat count depends on block size");
+    for (size_t i = 0; i < da.rrCount(); ++i) {
+        zassert_equal(da.rr(i), db.rr(i), "RR[%u] depends on block size", (unsigned)i);
+    }
+}
+
+ZTEST(beat_detector, test_flatline_invalidates)
+{
+    PpgSynth ppg;
+    ppg.bpm = 60.0f;
+    HrFilter f;
+    BeatDetector d;
+    start(ppg, f, d, 50);
+    run_pipeline(ppg, f, d, 10.0f);
+    float est = 0.0f;
+    zassert_true(d.bpm(est), "no estimate before flatline");
+
+    /* Pulse gone (finger lifted onto a constant level) */
+    ppg.ac = 0.0f;
+    run_pipeline(ppg, f, d, 4.0f);
+    zassert_false(d.bpm(est), "estimate still valid after 4 s without beats");
+
+    /* Pulse back: valid again after a few beats */
+    ppg.ac = 1000.0f;
+    run_pipeline(ppg, f, d, 8.0f);
+    zassert_true(d.bpm(est), "no estimate after pulse returned");
+    zassert_within(est, 60.0f, 2.0f, "estimated %d BPM", (int)est);
+}
+
+ZTEST(beat_detector, test_amplitude_interpolates_peak)
+{
+    /* A cosine whose peaks fall between samples: the refined height is
+     * the true peak, the trough is the lowest sample */
+    const float PI = 3.14159265358979323846f;
+    const float period = 27.0f, offset = 0.3f, a = 1000.0f;
+    BeatDetector d;
+    d.init(50);
+    float lowest = a;
+    for (int n = 0; n < 50 * 15; ++n) {
+        const float x = a * cosf(2.0f * PI * ((float)n - offset) / period);
+        d.process(&x, 1);
+        if (x < lowest) lowest = x;
+    }
+    zassert_true(d.rrCount() > 0, "no beats");
+    for (size_t i = 0; i < d.rrCount(); ++i) {
+        zassert_within(d.amplitude(i), a - lowest, 0.5f, "amplitude[%u] %d", (unsigned)i,
+                       (int)d.amplitude(i));
+    }
+}
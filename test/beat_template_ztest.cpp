@@ -0,0 +1,191 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "beat_template.h"
+#include "beat_detector.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr size_t BLOCK = 10;       /* 200 ms per wake-up @ 50 Hz */
+
+/* Band-pass -> detector -> template, as in the HR thread */
+struct Chain {
+    HrFilter f;
+    BeatDetector d;
+    BeatTemplate t;
+    uint32_t seen = 0;
+    uint32_t scored = 0;
+    uint32_t good = 0;
+    float worst = 1.0f;
+
+    void start(PpgSynth& ppg, uint32_t fs)
+    {
+        ppg.fs = (float)fs;
+        PpgSynth probe = ppg;
+        zassert_true(f.init(fs, probe.next()), "no table for %u Hz", fs);
+        d.init(fs);
+        t.init(fs);
+    }
+
+    /* Returns the correlation of the last beat scored in the block, or 2 */
+    float block(float* buf, size_t n)
+    {
+        f.process(buf, buf, n);
+        d.process(buf, n);
+        t.process(buf, n);
+        const uint32_t fresh = d.beats() - seen;
+        seen = d.beats();
+        if (fresh == 0 || !t.onBeat(d.lastPeakAge(), fresh == 1 && d.runLength() > 0)) {
+            return 2.0f;
+        }
+        BeatTemplate::Beat b;
+        zassert_true(t.lastBeat(b), "scored beat not reported");
+        ++scored;
+        good += b.good ? 1 : 0;
+        if (b.correlation < worst) worst = b.correlation;
+        return b.correlation;
+    }
+
+    void run(PpgSynth& ppg, float seconds)
+    {
+        float buf[BLOCK];
+        const size_t total = (size_t)(seconds * ppg.fs);
+        for (size_t off = 0; off < total; off += BLOCK) {
+            const size_t n = total - off < BLOCK ? total - off : BLOCK;
+            ppg.fill(buf, n);
+            block(buf, n);
+        }
+    }
+};
+
+ZTEST_SUITE(beat_template, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(beat_template, test_clean_beats_match_template)
+{
+    const uint32_t fs_list[] = { 50, 100 };
+    const float rates[] = { 45, 60, 90, 150 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            PpgSynth ppg;
+            ppg.bpm = bpm;
+            ppg.noise = 10.0f;
+            Chain c;
+            c.start(ppg, fs);
+            c.run(ppg, 5.0f);          /* band-pass settles */
+            c.scored = c.good = 0;
+            c.worst = 1.0f;
+            c.run(ppg, 20.0f);
+
+            const int expected = (int)(20.0f * bpm / 60.0f);
+            zassert_true((int)c.scored >= expected - 2, "%u Hz, %d BPM: %u of %d beats scored",
+                         fs, (int)bpm, c.scored, expected);
+            zassert_equal(c.good, c.scored, "%u Hz, %d BPM: %u good of %u, worst %d %%",
+                          fs, (int)bpm, c.good, c.scored, (int)(100.0f * c.worst));
+
+            BeatTemplate::Features feat;
+            zassert_true(c.t.features(feat), "no features");
+            /* The synthetic pulse scales with the period: the upstroke spans
+             * a fixed share of the RR, the notch sits between the waves */
+            const float rr_ms = 60000.0f / bpm;
+            TC_PRINT("%u Hz, %3d BPM: rise %d ms (%d %%), notch %d ms (%d %%)\n", fs, (int)bpm,
+                     (int)feat.rise_time_ms, (int)(100.0f * feat.rise_time_ms / rr_ms),
+                     (int)feat.notch_ms, (int)(100.0f * feat.notch_ms / rr_ms));
+            zassert_within(feat.rise_time_ms / rr_ms, 0.2f, 0.08f, "%u Hz, %d BPM: rise %d ms",
+                           fs, (int)bpm, (int)feat.rise_time_ms);
+            zassert_true(feat.notch, "%u Hz, %d BPM: no notch", fs, (int)bpm);
+            zassert_within(feat.notch_ms / rr_ms, 0.2f, 0.1f, "%u Hz, %d BPM: notch %d ms",
+                           fs, (int)bpm, (int)feat.notch_ms);
+        }
+    }
+}
+
+ZTEST(beat_template, test_no_notch_without_dicrotic_wave)
+{
+    PpgSynth ppg;
+    ppg.bpm = 75.0f;
+    ppg.dicrotic = 0.0f;
+    Chain c;
+    c.start(ppg, 50);
+    c.run(ppg, 20.0f);
+    BeatTemplate::Features feat;
+    zassert_true(c.t.features(feat), "no features");
+    zassert_false(feat.notch, "notch at %d ms", (int)feat.notch_ms);
+    zassert_true(feat.rise_time_ms > 0.0f, "no rise time");
+}
+
+ZTEST(beat_template, test_artifact_beat_flagged)
+{
+    PpgSynth ppg;
+    ppg.bpm = 60.0f;
+    Chain c;
+    c.start(ppg, 50);
+    c.run(ppg, 15.0f);
+
+    /* A slow bump across the diastole of one beat: the detector still sees
+     * the right peaks, the shape is wrong */
+    float buf[BLOCK];
+    float hit = 2.0f;
+    for (size_t off = 0; off < 250; off += BLOCK) {
+        ppg.fill(buf, BLOCK);
+        for (size_t i = 0; i < BLOCK; ++i) {
+            const float k = (float)(off + i);
+            if (k >= 10.0f && k < 40.0f) {
+                buf[i] -= 600.0f * sinf(3.14159265f * (k - 10.0f) / 30.0f);
+            }
+        }
+        const float r = c.block(buf, BLOCK);
+        if (r < hit) hit = r;
+    }
+    TC_PRINT("artifact beat: correlation %d %%\n", (int)(100.0f * hit));
+    zassert_true(hit < BeatTemplate::GOOD_CORR, "artifact beat scored %d %%", (int)(100.0f * hit));
+
+    /* The template kept its shape: clean beats score well right away */
+    c.scored = c.good = 0;
+    c.run(ppg, 10.0f);
+    zassert_true(c.scored >= 8, "%u beats scored", c.scored);
+    zassert_equal(c.good, c.scored, "%u good of %u after the artifact", c.good, c.scored);
+}
+
+/* One beat of `shape` cycles of a cosine, peak to peak, `len` samples */
+static void push_beat(BeatTemplate& t, float cycles, size_t len)
+{
+    float buf[64];
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = cosf(2.0f * 3.14159265f * cycles * (float)(i + 1) / (float)len);
+    }
+    t.process(buf, len);
+}
+
+ZTEST(beat_template, test_relearns_a_new_shape)
+{
+    BeatTemplate t;
+    t.init(50);
+    float x = 1.0f;
+    t.process(&x, 1);
+    zassert_false(t.onBeat(0.0f, false), "first peak has no segment");
+    for (int i = 0; i < 10; ++i) {
+        push_beat(t, 1.0f, 50);
+        t.onBeat(0.0f, true);
+    }
+    BeatTemplate::Beat b;
+    zassert_true(t.lastBeat(b) && b.good, "clean beat not good");
+
+    /* A different shape is rejected until RELEARN_AFTER in a row */
+    for (size_t i = 0; i < BeatTemplate::RELEARN_AFTER; ++i) {
+        push_beat(t, 2.0f, 50);
+        zassert_true(t.onBeat(0.0f, true), "beat %u not scored", (unsigned)i);
+        zassert_true(t.lastBeat(b) && !b.good, "beat %u scored %d %%", (unsigned)i,
+                     (int)(100.0f * b.correlation));
+    }
+    push_beat(t, 2.0f, 50);
+    t.onBeat(0.0f, true);
+    zassert_true(t.lastBeat(b) && b.good, "new shape not learned: %d %%",
+                 (int)(100.0f * b.correlation));
+
+    /* A gap: the next peak starts a segment, nothing is scored */
+    push_beat(t, 2.0f, 50);
+    zassert_false(t.onBeat(0.0f, false), "non-adjacent beat scored");
+    t.reset();
+    BeatTemplate::Features f;
+    zassert_false(t.lastBeat(b) || t.features(f), "reset kept the template");
+}
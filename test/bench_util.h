@@ -0,0 +1,39 @@
+/*
+ * CareLoop - Cycle measurement helpers for ztest benchmarks
+ */
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+#include <stdint.h>
+
+/* Run fn once and return the elapsed timing cycles (DWT on Cortex-M) */
+template <typename Fn>
+static inline uint64_t bench_cycles(Fn &&fn)
+{
+    static bool initialized;
+    if (!initialized) {
+        timing_init();
+        initialized = true;
+    }
+    timing_start();
+    timing_t start = timing_counter_get();
+    fn();
+    timing_t end = timing_counter_get();
+    timing_stop();
+    return timing_cycles_get(&start, &end);
+}
+
+/* Cycles per processed sample, in hundredths to keep printk integer-only */
+static inline uint32_t bench_cps_x100(uint64_t cycles, uint32_t samples)
+{
+    return samples ? (uint32_t)((cycles * 100u) / samples) : 0u;
+}
+
+#define BENCH_PRINT(label, cycles, samples)                                     \
+    TC_PRINT("%-28s %6u.%02u cycles/sample\n", (label),                         \
+             bench_cps_x100((cycles), (samples)) / 100u,                        \
+             bench_cps_x100((cycles), (samples)) % 100u)
+
+#endif /* BENCH_UTIL_H */
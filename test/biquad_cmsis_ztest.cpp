@@ -0,0 +1,135 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_filter.h"
+#include "biquad_fixed.h"
+
+/*
+ * Backend parity: identical buffers through the portable C++ loops and the
+ * CMSIS-DSP kernels. Needs CONFIG_CMSIS_DSP + CONFIG_CMSIS_DSP_FILTERING
+ * (see cmsis_dsp.conf); skipped otherwise.
+ */
+
+ZTEST_SUITE(biquad_cmsis, NULL, NULL, NULL, NULL, NULL);
+
+#if BIQUAD_HAS_CMSIS
+
+static constexpr size_t LEN = 2000;
+static constexpr size_t BLOCK = 40;
+
+static float f_in[LEN];
+static float f_portable[LEN];
+static float f_cmsis[LEN];
+static int32_t q_in[LEN];
+static int32_t q_portable[LEN];
+static int32_t q_cmsis[LEN];
+
+static void fill_ppg()
+{
+    const float PI = 3.14159265358979323846f;
+    for (size_t i = 0; i < LEN; ++i) {
+        float t = (float)i / 100.0f;
+        /* DC step, pulse and a spike to exercise the transients */
+        float v = 0.3f + 0.02f * sinf(2.0f * PI * 1.3f * t) + 0.005f * sinf(2.0f * PI * 9.0f * t);
+        if (i == 1200) v += 0.2f;
+        f_in[i] = v;
+        q_in[i] = q31_sat((int64_t)(v * 2147483648.0f));
+    }
+}
+
+ZTEST(biquad_cmsis, test_f32_parity)
+{
+    fill_ppg();
+    BiquadCascadeDF2T<3> portable, cmsis;
+    hr_filter_load(portable);
+    hr_filter_load(cmsis);
+    /* Blocked so state hand-over between calls is covered too */
+    for (size_t off = 0; off < LEN; off += BLOCK) {
+        portable.processBufferPortable(f_in + off, f_portable + off, BLOCK);
+        cmsis.processBufferCmsis(f_in + off, f_cmsis + off, BLOCK);
+    }
+    float max_dev = 0.0f;
+    for (size_t i = 0; i < LEN; ++i) {
+        float d = fabsf(f_portable[i] - f_cmsis[i]);
+        if (d > max_dev) max_dev = d;
+    }
+    TC_PRINT("f32 max deviation: %e\n", (double)max_dev);
+    zassert_true(max_dev < 1e-5f, "f32 backends deviate by %e", (double)max_dev);
+}
+
+ZTEST(biquad_cmsis, test_q31_parity)
+{
+    fill_ppg();
+    BiquadCascadeDF2T<3> proto;
+    hr_filter_load(proto);
+    BiquadCascadeQ31<3> portable, cmsis;
+    portable.setCoeffs(proto);
+    cmsis.setCoeffs(proto);
+    for (size_t off = 0; off < LEN; off += BLOCK) {
+        portable.processBufferPortable(q_in + off, q_portable + off, BLOCK);
+        cmsis.processBufferCmsis(q_in + off, q_cmsis + off, BLOCK);
+    }
+    int64_t max_dev = 0;
+    for (size_t i = 0; i < LEN; ++i) {
+        int64_t d = (int64_t)q_portable[i] - (int64_t)q_cmsis[i];
+        if (d < 0) d = -d;
+        if (d > max_dev) max_dev = d;
+    }
+    /* DF2T with error feedback vs DF1 32x64: different rounding, same filter */
+    double rel = (double)max_dev / 2147483648.0;
+    TC_PRINT("q31 max deviation: %e of full scale\n", rel);
+    zassert_true(rel < 1e-6, "q31 backends deviate by %e of full scale", rel);
+}
+
+ZTEST(biquad_cmsis, test_q31_settle_parity)
+{
+    BiquadCascadeDF2T<3> proto;
+    hr_filter_load(proto);
+    BiquadCascadeQ31<3> portable, cmsis;
+    portable.setCoeffs(proto);
+    cmsis.setCoeffs(proto);
+    const int32_t dc = 1 << 29;
+    portable.settle(dc);
+    cmsis.settle(dc);
+    for (size_t i = 0; i < 200; ++i) {
+        q_in[i] = dc;
+    }
+    portable.processBufferPortable(q_in, q_portable, 200);
+    cmsis.processBufferCmsis(q_in, q_cmsis, 200);
+    for (size_t i = 0; i < 200; ++i) {
+        zassert_true(q_portable[i] < 64 && q_portable[i] > -64, "portable not settled");
+        zassert_true(q_cmsis[i] < 64 && q_cmsis[i] > -64, "cmsis not settled");
+    }
+
+    /* Rebasing both onto the DC level keeps them settled on zero input */
+    portable.rebase(dc);
+    cmsis.rebase(dc);
+    for (size_t i = 0; i < 200; ++i) {
+        q_in[i] = 0;
+    }
+    portable.processBufferPortable(q_in, q_portable, 200);
+    cmsis.processBufferCmsis(q_in, q_cmsis, 200);
+    for (size_t i = 0; i < 200; ++i) {
+        zassert_true(q_portable[i] < 64 && q_portable[i] > -64, "portable moved on rebase");
+        zassert_true(q_cmsis[i] < 64 && q_cmsis[i] > -64, "cmsis moved on rebase");
+    }
+}
+
+#else
+
+ZTEST(biquad_cmsis, test_f32_parity)
+{
+    ztest_test_skip();
+}
+
+ZTEST(biquad_cmsis, test_q31_parity)
+{
+    ztest_test_skip();
+}
+
+ZTEST(biquad_cmsis, test_q31_settle_parity)
+{
+    ztest_test_skip();
+}
+
+#endif
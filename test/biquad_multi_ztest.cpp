@@ -0,0 +1,163 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_filter.h"
+#include "bench_util.h"
+
+/* Same band-pass as hr_filter.cpp: [b0,b1,b2,a1,a2] per section */
+static const float SOS[3][5] = {
+    { 0.967694809f, -1.935389618f,  0.967694809f, -1.954001962f,  0.954619251f },
+    { 1.0f,         -2.0f,          1.0f,         -1.980323859f,  0.980949464f },
+    { 0.036574836f,  0.073149672f,  0.036574836f, -1.390895281f,  0.537194625f }
+};
+
+static constexpr size_t FRAMES = 1000;
+static constexpr size_t MAX_CH = 8;
+
+static float in_buf[FRAMES * MAX_CH];
+static float out_buf[FRAMES * MAX_CH];
+static float ref_in[FRAMES];
+static float ref_out[FRAMES];
+
+static BiquadDF2T section(size_t i)
+{
+    BiquadDF2T q;
+    q.b0 = SOS[i][0]; q.b1 = SOS[i][1]; q.b2 = SOS[i][2];
+    q.a1 = SOS[i][3]; q.a2 = SOS[i][4];
+    return q;
+}
+
+template <size_t N>
+static void load_scalar(BiquadCascadeDF2T<N> &c)
+{
+    for (size_t i = 0; i < N; ++i) c.sec[i] = section(i);
+}
+
+template <size_t N, size_t C>
+static void load_multi(BiquadCascadeMultiDF2T<N, C> &c)
+{
+    for (size_t i = 0; i < N; ++i) c.setSection(i, section(i));
+}
+
+/* Distinct per-channel test signal: DC offset + tone + a small ramp */
+static float test_signal(size_t ch, size_t n)
+{
+    const float fs = 100.0f;
+    const float PI = 3.14159265358979323846f;
+    float t = (float)n / fs;
+    return 1000.0f * (float)(ch + 1) + sinf(2.0f * PI * (0.5f + (float)ch) * t)
+         + 0.01f * (float)n;
+}
+
+template <size_t C>
+static void check_equivalence()
+{
+    BiquadCascadeMultiDF2T<3, C> multi;
+    load_multi(multi);
+    for (size_t f = 0; f < FRAMES; ++f) {
+        for (size_t c = 0; c < C; ++c) in_buf[f * C + c] = test_signal(c, f);
+    }
+    multi.processBuffer(in_buf, out_buf, FRAMES);
+
+    for (size_t c = 0; c < C; ++c) {
+        BiquadCascadeDF2T<3> ref;
+        load_scalar(ref);
+        for (size_t f = 0; f < FRAMES; ++f) ref_in[f] = test_signal(c, f);
+        ref.processBufferPortable(ref_in, ref_out, FRAMES);
+        for (size_t f = 0; f < FRAMES; ++f) {
+            float d = fabsf(out_buf[f * C + c] - ref_out[f]);
+            float tol = 1e-5f * (1.0f + fabsf(ref_out[f]));
+            zassert_true(d <= tol, "C=%u ch=%u frame=%u: multi=%f scalar=%f",
+                         (unsigned)C, (unsigned)c, (unsigned)f,
+                         (double)out_buf[f * C + c], (double)ref_out[f]);
+        }
+    }
+}
+
+ZTEST_SUITE(biquad_multi, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(biquad_multi, test_matches_scalar_cascade)
+{
+    check_equivalence<1>();
+    check_equivalence<2>();
+    check_equivalence<5>();
+    check_equivalence<8>();
+}
+
+ZTEST(biquad_multi, test_per_channel_coefficients)
+{
+    /* Channel 1 runs only the LP section, channel 0 the full band-pass */
+    BiquadCascadeMultiDF2T<3, 2> multi;
+    load_multi(multi);
+    BiquadDF2T pass;
+    pass.b0 = 1.0f;
+    multi.setSection(0, 1, pass);
+    multi.setSection(1, 1, pass);
+
+    BiquadCascadeDF2T<3> ref_bp;
+    load_scalar(ref_bp);
+    BiquadCascadeDF2T<1> ref_lp;
+    ref_lp.sec[0] = section(2);
+
+    for (size_t f = 0; f < FRAMES; ++f) {
+        float frame[2] = { test_signal(0, f), test_signal(1, f) };
+        float y0 = ref_bp.process(frame[0]);
+        float y1 = ref_lp.process(frame[1]);
+        multi.processFrame(frame);
+        zassert_within(frame[0], y0, 1e-5f * (1.0f + fabsf(y0)), "ch0 frame %u", (unsigned)f);
+        zassert_within(frame[1], y1, 1e-5f * (1.0f + fabsf(y1)), "ch1 frame %u", (unsigned)f);
+    }
+}
+
+ZTEST(biquad_multi, test_reset_and_in_place)
+{
+    BiquadCascadeMultiDF2T<3, 4> multi;
+    load_multi(multi);
+    for (size_t f = 0; f < FRAMES; ++f) {
+        for (size_t c = 0; c < 4; ++c) in_buf[f * 4 + c] = test_signal(c, f);
+    }
+    multi.processBuffer(in_buf, out_buf, FRAMES);
+
+    /* After reset, filtering in place must reproduce the first run */
+    multi.reset();
+    multi.processBuffer(in_buf, in_buf, FRAMES);
+    for (size_t i = 0; i < FRAMES * 4; ++i) {
+        zassert_equal(in_buf[i], out_buf[i], "in-place mismatch at %u", (unsigned)i);
+    }
+}
+
+template <size_t C>
+static void bench_channels()
+{
+    for (size_t f = 0; f < FRAMES; ++f) {
+        for (size_t c = 0; c < C; ++c) in_buf[f * C + c] = test_signal(c, f);
+    }
+
+    /* Baseline: C separate passes over the scalar cascade */
+    BiquadCascadeDF2T<3> scalar[C];
+    for (auto &s : scalar) load_scalar(s);
+    uint64_t scalar_cycles = bench_cycles([&] {
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t f = 0; f < FRAMES; ++f) {
+                out_buf[f * C + c] = scalar[c].process(in_buf[f * C + c]);
+            }
+        }
+    });
+
+    BiquadCascadeMultiDF2T<3, C> multi;
+    load_multi(multi);
+    uint64_t multi_cycles = bench_cycles([&] {
+        multi.processBuffer(in_buf, out_buf, FRAMES);
+    });
+
+    TC_PRINT("C=%u\n", (unsigned)C);
+    BENCH_PRINT("  scalar x C", scalar_cycles, FRAMES * C);
+    BENCH_PRINT("  multi SoA", multi_cycles, FRAMES * C);
+}
+
+ZTEST(biquad_multi, test_bench_cycles_per_sample)
+{
+    bench_channels<2>();
+    bench_channels<4>();
+    bench_channels<8>();
+}
@@ -0,0 +1,183 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "decimator.h"
+#include "hr_filter.h"
+#include "bench_util.h"
+
+static const float PI = 3.14159265358979323846f;
+
+static constexpr size_t IN_LEN = 16000; /* 40 s @ 400 Hz */
+static float in_buf[IN_LEN];
+static float out_buf[IN_LEN];
+static float ref_buf[IN_LEN];
+
+static void fill_tone(float* v, size_t len, float fs, float dc, float amp, float f)
+{
+    for (size_t i = 0; i < len; ++i) {
+        v[i] = dc + amp * sinf(2.0f * PI * f * (float)i / fs);
+    }
+}
+
+/* Amplitude of the f Hz component over v[start..len) by quadrature correlation */
+static float tone_amp(const float* v, size_t start, size_t len, float fs, float f)
+{
+    double c = 0.0, s = 0.0;
+    for (size_t i = start; i < len; ++i) {
+        double ph = 2.0 * (double)PI * f * (double)i / fs;
+        c += v[i] * cos(ph);
+        s += v[i] * sin(ph);
+    }
+    double n = (double)(len - start);
+    return (float)(2.0 * sqrt(c * c + s * s) / n);
+}
+
+ZTEST_SUITE(decimator, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(decimator, test_factor_range)
+{
+    PolyphaseDecimator<> d;
+    zassert_false(d.init(1), "accepted factor 1");
+    zassert_false(d.init(33), "accepted factor 33");
+    zassert_true(d.init(2), "rejected factor 2");
+    zassert_true(d.init(32), "rejected factor 32");
+    zassert_equal(d.factor(), 32u, "factor not stored");
+
+    /* Only factors landing on a band-pass table rate are offered */
+    zassert_equal(hr_filter_decimation(400, 50, 32), 8u, "400 -> 50 Hz");
+    zassert_equal(hr_filter_decimation(1000, 50, 32), 20u, "1000 -> 50 Hz");
+    zassert_equal(hr_filter_decimation(1000, 25, 32), 20u, "1000 -> 50 Hz, 40 Hz has no table");
+    zassert_equal(hr_filter_decimation(3200, 50, 32), 32u, "3200 -> 100 Hz");
+    zassert_equal(hr_filter_decimation(400, 25, 32), 16u, "400 -> 25 Hz");
+    zassert_equal(hr_filter_decimation(50, 50, 32), 1u, "50 Hz needs no decimation");
+}
+
+ZTEST(decimator, test_dc_gain_and_output_count)
+{
+    PolyphaseDecimator<> d;
+    d.init(8);
+    d.settle(50000.0f);
+    for (size_t i = 0; i < 800; ++i) in_buf[i] = 50000.0f;
+    size_t n = d.process(in_buf, 800, out_buf);
+    zassert_equal(n, 100u, "800 samples / 8 gave %u", (unsigned)n);
+    for (size_t i = 0; i < n; ++i) {
+        zassert_within(out_buf[i], 50000.0f, 0.5f, "DC out[%u] = %f",
+                       (unsigned)i, (double)out_buf[i]);
+    }
+}
+
+ZTEST(decimator, test_block_splits_in_place)
+{
+    fill_tone(in_buf, IN_LEN, 400.0f, 1000.0f, 10.0f, 1.2f);
+    PolyphaseDecimator<> a;
+    a.init(8);
+    size_t n_ref = a.process(in_buf, IN_LEN, ref_buf);
+
+    /* Uneven blocks that do not line up with the factor, decimated in place */
+    PolyphaseDecimator<> b;
+    b.init(8);
+    const size_t sizes[] = { 1, 13, 64, 7, 200, 32 };
+    size_t off = 0, produced = 0, k = 0;
+    while (off < IN_LEN) {
+        size_t n = sizes[k++ % ARRAY_SIZE(sizes)];
+        if (n > IN_LEN - off) n = IN_LEN - off;
+        float blk[200];
+        for (size_t i = 0; i < n; ++i) blk[i] = in_buf[off + i];
+        size_t got = b.process(blk, n, blk);
+        for (size_t i = 0; i < got; ++i) out_buf[produced + i] = blk[i];
+        produced += got;
+        off += n;
+    }
+    zassert_equal(produced, n_ref, "produced %u, expected %u", (unsigned)produced, (unsigned)n_ref);
+    for (size_t i = 0; i < n_ref; ++i) {
+        zassert_equal(out_buf[i], ref_buf[i], "mismatch at %u", (unsigned)i);
+    }
+}
+
+ZTEST(decimator, test_passband_and_alias_rejection)
+{
+    const size_t skip = 50; /* one second at 50 Hz, past the FIR delay */
+
+    /* 1.2 Hz (72 BPM) passes unchanged */
+    PolyphaseDecimator<> d;
+    d.init(8);
+    fill_tone(in_buf, IN_LEN, 400.0f, 0.0f, 10.0f, 1.2f);
+    size_t n = d.process(in_buf, IN_LEN, out_buf);
+    float pass = tone_amp(out_buf, skip, n, 50.0f, 1.2f);
+    zassert_within(pass, 10.0f, 0.1f, "1.2 Hz amplitude %f", (double)pass);
+
+    /* 45 Hz would fold onto 5 Hz at 50 Hz out, right inside the HR band */
+    d.init(8);
+    fill_tone(in_buf, IN_LEN, 400.0f, 0.0f, 10.0f, 45.0f);
+    n = d.process(in_buf, IN_LEN, out_buf);
+    float alias = tone_amp(out_buf, skip, n, 50.0f, 5.0f);
+    zassert_true(alias < 0.01f, "45 Hz aliased to 5 Hz with amplitude %f", (double)alias);
+
+    /* 25 Hz out: the raised cutoff keeps the 7 Hz edge, and 18 Hz, which
+     * folds onto it, stays out */
+    d.init(16, 25);
+    fill_tone(in_buf, IN_LEN, 400.0f, 0.0f, 10.0f, 7.0f);
+    n = d.process(in_buf, IN_LEN, out_buf);
+    const float edge = tone_amp(out_buf, skip, n, 25.0f, 7.0f);
+    zassert_true(edge > 8.0f, "7 Hz amplitude %f at 25 Hz out", (double)edge);
+    d.init(16, 25);
+    fill_tone(in_buf, IN_LEN, 400.0f, 0.0f, 10.0f, 18.0f);
+    n = d.process(in_buf, IN_LEN, out_buf);
+    alias = tone_amp(out_buf, skip, n, 25.0f, 7.0f);
+    zassert_true(alias < 0.02f, "18 Hz aliased to 7 Hz with amplitude %f", (double)alias);
+}
+
+ZTEST(decimator, test_feeds_hr_filter_at_every_rate)
+{
+    const uint32_t rates[] = { 400, 800, 1000, 1600, 3200 };
+    const uint32_t targets[] = { 25, 50 };
+    for (uint32_t target : targets) {
+        for (uint32_t fs : rates) {
+            uint32_t m = hr_filter_decimation(fs, target, 32);
+            uint32_t fs_out = fs / m;
+            PolyphaseDecimator<> d;
+            zassert_true(d.init(m, fs_out), "factor %u rejected", m);
+            HrFilter f;
+            zassert_true(f.init(fs_out), "no HR table for %u Hz", fs_out);
+            zassert_equal(f.sampleRate(), fs_out, "no HR table for %u Hz", fs_out);
+
+            /* 20 s of PPG-like input, decimated then band-passed */
+            const size_t len = (size_t)fs * 20u;
+            const size_t chunk = 1000;
+            size_t n = 0;
+            for (size_t off = 0; off < len; off += chunk) {
+                for (size_t i = 0; i < chunk; ++i) {
+                    in_buf[i] = 50000.0f + 10.0f * sinf(2.0f * PI * 1.2f * (float)(off + i) / (float)fs);
+                }
+                n += d.process(in_buf, chunk, out_buf + n);
+            }
+            f.process(out_buf, out_buf, n);
+            float amp = tone_amp(out_buf, n / 2, n, (float)fs_out, 1.2f);
+            zassert_true(amp > 9.0f && amp < 10.5f, "%u Hz / %u: 1.2 Hz amplitude %f",
+                         fs, m, (double)amp);
+        }
+    }
+}
+
+ZTEST(decimator, test_bench_vs_full_rate)
+{
+    const size_t len = 4000;
+    fill_tone(in_buf, len, 400.0f, 50000.0f, 10.0f, 1.2f);
+
+    HrFilter full;
+    full.init(400);
+    uint64_t full_cycles = bench_cycles([&] { full.process(in_buf, out_buf, len); });
+
+    PolyphaseDecimator<> d;
+    d.init(8);
+    HrFilter low;
+    low.init(50);
+    uint64_t dec_cycles = bench_cycles([&] {
+        size_t n = d.process(in_buf, len, ref_buf);
+        low.process(ref_buf, ref_buf, n);
+    });
+
+    TC_PRINT("HR band-pass at 400 Hz input\n");
+    BENCH_PRINT("  full rate", full_cycles, len);
+    BENCH_PRINT("  decimate x8 + 50 Hz", dec_cycles, len);
+}
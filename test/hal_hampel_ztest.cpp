@@ -0,0 +1,192 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+#include <algorithm>
+
+#include "hal_hampel.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+#include "bench_util.h"
+
+/* Raw MAX30102-like counts (pulse lowers the count), with a spike of
+ * +/-amp every `every` samples */
+struct SpikySynth {
+    PpgSynth ppg;
+    uint32_t every = 0;
+    float amp = 20000.0f;
+    uint32_t n = 0;
+    uint32_t spikes = 0;
+
+    float next(float& clean)
+    {
+        clean = 2.0f * ppg.dc - ppg.next();
+        ++n;
+        if (every && n % every == 0) {
+            ++spikes;
+            return clean + ((spikes & 1) ? amp : -amp);
+        }
+        return clean;
+    }
+};
+
+static void start(hal_hampel_t& h)
+{
+    hal_hampel_init(&h, 7, 3.0f, 16.0f);
+}
+
+ZTEST_SUITE(hal_hampel, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hal_hampel, test_median_matches_sort)
+{
+    const uint8_t windows[] = { 5, 7, 15, 31 };
+    for (uint8_t w : windows) {
+        hal_median_t m;
+        hal_median_init(&m, w);
+        float hist[600];
+        uint32_t seed = 31337u + w;
+        for (size_t i = 0; i < 600; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            /* Coarse values so ties are frequent */
+            hist[i] = (float)((seed >> 20) % 64);
+            const float med = hal_median_push(&m, hist[i]);
+
+            const size_t n = i + 1 < w ? i + 1 : w;
+            float sorted[HAL_HAMPEL_MAX_WINDOW];
+            std::copy(hist + i + 1 - n, hist + i + 1, sorted);
+            std::sort(sorted, sorted + n);
+            const float ref = (n & 1) ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+            zassert_equal(med, ref, "window %u, sample %u: median %d vs %d",
+                          w, (unsigned)i, (int)med, (int)ref);
+        }
+    }
+}
+
+ZTEST(hal_hampel, test_window_clamped_odd)
+{
+    hal_median_t m;
+    hal_median_init(&m, 2);
+    zassert_equal(m.window, HAL_HAMPEL_MIN_WINDOW, "window %u", m.window);
+    hal_median_init(&m, 10);
+    zassert_equal(m.window, 11, "window %u", m.window);
+    hal_median_init(&m, 200);
+    zassert_equal(m.window, HAL_HAMPEL_MAX_WINDOW, "window %u", m.window);
+}
+
+ZTEST(hal_hampel, test_spikes_removed_before_band_pass)
+{
+    /* A spike rings through the high-pass sections; removing it first
+     * leaves the band-passed PPG as if the spike never happened. The
+     * filtered stream lags by half the window, so the references do too */
+    SpikySynth src;
+    src.ppg.fs = 100.0f;
+    src.every = 97;
+    hal_hampel_t h;
+    start(h);
+    HrFilter f_clean, f_raw, f_fixed;
+    float c0;
+    const float first = src.next(c0);
+    f_clean.init(100, c0);
+    f_raw.init(100, first);
+    f_fixed.init(100, first);
+
+    const int lag = h.values.window / 2;
+    float clean_hist[8] = {}, raw_hist[8] = {};
+    float err_raw = 0.0f, err_fixed = 0.0f, sig = 0.0f;
+    uint32_t replaced = 0;
+    for (int i = 0; i < 3000; ++i) {
+        float c_now;
+        const float r_now = src.next(c_now);
+        float fixed = r_now;
+        replaced += hal_hampel_update(&h, &fixed) ? 1 : 0;
+        clean_hist[i % 8] = c_now;
+        raw_hist[i % 8] = r_now;
+        float clean = clean_hist[(i + 8 - lag) % 8];
+        float raw = raw_hist[(i + 8 - lag) % 8];
+        float yc, yr, yf;
+        f_clean.process(&clean, &yc, 1);
+        f_raw.process(&raw, &yr, 1);
+        f_fixed.process(&fixed, &yf, 1);
+        if (i >= 500) {
+            sig += yc * yc;
+            err_raw += (yr - yc) * (yr - yc);
+            err_fixed += (yf - yc) * (yf - yc);
+        }
+    }
+    const float snr_raw = 10.0f * log10f(sig / err_raw);
+    const float snr_fixed = 10.0f * log10f(sig / (err_fixed + 1e-9f));
+    TC_PRINT("spikes: %u in, %u replaced; band-passed SNR %d dB -> %d dB\n",
+             src.spikes, replaced, (int)snr_raw, (int)snr_fixed);
+    zassert_true(replaced >= src.spikes, "missed spikes: %u of %u", replaced, src.spikes);
+    zassert_true(replaced <= src.spikes + src.spikes / 2, "%u replaced for %u spikes",
+                 replaced, src.spikes);
+    zassert_equal(h.replaced, replaced, "count not kept");
+    zassert_true(snr_fixed > snr_raw + 20.0f, "SNR %d -> %d dB", (int)snr_raw, (int)snr_fixed);
+}
+
+ZTEST(hal_hampel, test_clean_ppg_untouched)
+{
+    const uint32_t fs_list[] = { 50, 100, 400 };
+    const float rates[] = { 45, 75, 150 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            SpikySynth src;
+            src.ppg.fs = (float)fs;
+            src.ppg.bpm = bpm;
+            src.ppg.noise = 5.0f;
+            hal_hampel_t h;
+            start(h);
+            const int n = (int)(20 * fs);
+            for (int i = 0; i < n; ++i) {
+                float clean;
+                float x = src.next(clean);
+                hal_hampel_update(&h, &x);
+            }
+            zassert_true(h.replaced * 200u < (uint32_t)n, "%u Hz, %d BPM: %u of %d replaced",
+                         fs, (int)bpm, h.replaced, n);
+        }
+    }
+}
+
+ZTEST(hal_hampel, test_reset_waits_for_full_window)
+{
+    hal_hampel_t h;
+    start(h);
+    for (int i = 0; i < 20; ++i) {
+        float x = 100000.0f;
+        hal_hampel_update(&h, &x);
+    }
+    hal_hampel_reset(&h);
+    /* A new contact level must pass, not be pulled to the old median */
+    for (int i = 0; i < 7; ++i) {
+        float x = 50000.0f + (float)i;
+        zassert_false(hal_hampel_update(&h, &x), "replaced while filling");
+        zassert_equal(x, 50000.0f + (float)(i > 3 ? i - 3 : 0), "delay not kept");
+    }
+}
+
+ZTEST(hal_hampel, test_bench_cycles_per_sample)
+{
+    static float buf[1000];
+    SpikySynth src;
+    src.ppg.fs = 100.0f;
+    src.every = 97;
+    for (auto &v : buf) {
+        float clean;
+        v = src.next(clean);
+    }
+    const uint8_t windows[] = { 7, 31 };
+    for (uint8_t w : windows) {
+        hal_hampel_t h;
+        hal_hampel_init(&h, w, 3.0f, 16.0f);
+        volatile float sink = 0.0f;
+        uint64_t cycles = bench_cycles([&] {
+            for (size_t i = 0; i < 1000; ++i) {
+                float x = buf[i];
+                hal_hampel_update(&h, &x);
+                sink = x;
+            }
+        });
+        (void)sink;
+        TC_PRINT("window %u:\n", w);
+        BENCH_PRINT("  Hampel update", cycles, 1000);
+    }
+}
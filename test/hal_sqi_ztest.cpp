@@ -0,0 +1,104 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hal_sqi.h"
+#include "ppg_synth.h"
+
+/* Raw MAX30102 counts: the pulse (blood volume up) lowers the count */
+static hal_quality_t run(hal_sqi_t& s, PpgSynth& ppg, float seconds)
+{
+    hal_quality_t q = 0;
+    size_t n = (size_t)(seconds * ppg.fs);
+    for (size_t i = 0; i < n; ++i) {
+        q = hal_sqi_update(&s, 2.0f * ppg.dc - ppg.next());
+    }
+    return q;
+}
+
+static void print_components(const char* tag, const hal_sqi_t& s, hal_quality_t q)
+{
+    TC_PRINT("%s: q %d, perfusion %d%%, skew %d%%, regularity %d%%, concentration %d%%\n",
+             tag, q, (int)(s.perfusion * 100.0f), (int)(s.skewness * 100.0f),
+             (int)(s.regularity * 100.0f), (int)(s.concentration * 100.0f));
+}
+
+ZTEST_SUITE(hal_sqi, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hal_sqi, test_clean_pulse_scores_high)
+{
+    const float rates[] = { 40, 70, 120, 180 };
+    const uint32_t fs_list[] = { 50, 100, 400 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            PpgSynth ppg;
+            ppg.fs = (float)fs;
+            ppg.bpm = bpm;
+            hal_sqi_t s;
+            hal_sqi_init(&s, fs);
+            hal_quality_t q = run(s, ppg, 10.0f);
+            zassert_true(q >= HAL_QUALITY_GOOD, "%u Hz, %d BPM: quality %d",
+                         fs, (int)bpm, q);
+        }
+    }
+}
+
+ZTEST(hal_sqi, test_noise_scores_low)
+{
+    /* Same raw RMS as a healthy pulse, no pulse in it */
+    PpgSynth ppg;
+    ppg.fs = 100.0f;
+    ppg.ac = 0.0f;
+    ppg.noise = 1000.0f;
+    hal_sqi_t s;
+    hal_sqi_init(&s, 100);
+    hal_quality_t q = run(s, ppg, 10.0f);
+    print_components("noise", s, q);
+    zassert_true(q < HAL_QUALITY_POOR, "white noise quality %d", q);
+}
+
+ZTEST(hal_sqi, test_low_perfusion_scores_low)
+{
+    PpgSynth ppg;
+    ppg.fs = 100.0f;
+    ppg.ac = 20.0f;          /* 0.02 % of DC */
+    hal_sqi_t s;
+    hal_sqi_init(&s, 100);
+    hal_quality_t q = run(s, ppg, 10.0f);
+    zassert_true(q < HAL_QUALITY_POOR, "perfusion 0.02%% quality %d", q);
+}
+
+ZTEST(hal_sqi, test_motion_lowers_quality)
+{
+    /* Pulse plus irregular large steps (arm movement shifting the sensor) */
+    PpgSynth ppg;
+    ppg.fs = 100.0f;
+    hal_sqi_t s;
+    hal_sqi_init(&s, 100);
+    hal_quality_t clean = run(s, ppg, 8.0f);
+
+    uint32_t seed = 99u;
+    float offset = 0.0f;
+    hal_quality_t q = clean;
+    for (int i = 0; i < 800; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        if ((seed >> 24) < 8) {     /* ~3 steps per second */
+            offset = (float)((int)(seed >> 8) % 8000 - 4000);
+        }
+        q = hal_sqi_update(&s, 2.0f * ppg.dc - ppg.next() + offset);
+    }
+    print_components("motion", s, q);
+    zassert_true(q < clean / 2, "quality %d during motion, %d clean", q, clean);
+}
+
+ZTEST(hal_sqi, test_reset_forgets_window)
+{
+    PpgSynth ppg;
+    ppg.fs = 100.0f;
+    hal_sqi_t s;
+    hal_sqi_init(&s, 100);
+    run(s, ppg, 10.0f);
+    hal_sqi_reset(&s);
+    zassert_equal(s.seen, 0u, "window not cleared");
+    zassert_within(s.fs, 100.0f, 0.0f, "rate lost on reset");
+    zassert_true(hal_sqi_update(&s, 100000.0f) >= 1, "quality 0 is reserved");
+}
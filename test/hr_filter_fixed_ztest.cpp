@@ -0,0 +1,216 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_filter.h"
+#include "biquad_fixed.h"
+#include "bench_util.h"
+
+/*
+ * Every arithmetic variant of the HR band-pass must hold the same criteria
+ * as hr_filter_ztest.cpp. Test signals have unit amplitude; the fixed-point
+ * variants map +/-4.0 to full scale so transients keep headroom.
+ */
+
+static constexpr float FS = 100.0f;
+static constexpr float PI = 3.14159265358979323846f;
+static constexpr float TEST_FULL_SCALE = 4.0f;
+static constexpr size_t N = 3000;
+
+static float in_buf[N];
+static float out_buf[N];
+
+struct FloatVariant {
+    static constexpr const char* name = "float";
+    BiquadCascadeDF2T<3> c;
+    FloatVariant() { hr_filter_load(c); }
+    void run(const float* in, float* out, size_t n) { c.processBuffer(in, out, n); }
+};
+
+struct Q31Variant {
+    static constexpr const char* name = "q31";
+    BiquadCascadeQ31<3> c;
+    Q31Variant() { BiquadCascadeDF2T<3> p; hr_filter_load(p); c.setCoeffs(p); }
+    void run(const float* in, float* out, size_t n) {
+        const float k = 2147483648.0f / TEST_FULL_SCALE;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (float)c.process(q31_sat((int64_t)(in[i] * k))) / k;
+        }
+    }
+};
+
+struct Q15Variant {
+    static constexpr const char* name = "q15";
+    BiquadCascadeQ15<3> c;
+    Q15Variant() { BiquadCascadeDF2T<3> p; hr_filter_load(p); c.setCoeffs(p); }
+    void run(const float* in, float* out, size_t n) {
+        const float k = 32768.0f / TEST_FULL_SCALE;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (float)c.process((int16_t)lrintf(in[i] * k)) / k;
+        }
+    }
+};
+
+static float rms_range(const float* v, size_t start, size_t end)
+{
+    double acc = 0.0;
+    for (size_t i = start; i < end; ++i) acc += (double)v[i] * (double)v[i];
+    return end > start ? (float)sqrt(acc / (double)(end - start)) : 0.0f;
+}
+
+static void fill_tone(float f_hz, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) in_buf[i] = sinf(2.0f * PI * f_hz * (float)i / FS);
+}
+
+template <typename V>
+static void check_dc_reject()
+{
+    V v;
+    for (size_t i = 0; i < N; ++i) in_buf[i] = 1.0f;
+    v.run(in_buf, out_buf, N);
+    float dc_rms = rms_range(out_buf, N - 2500, N);
+    zassert_true(dc_rms < 5e-2f, "%s: DC RMS too high: %f", V::name, (double)dc_rms);
+}
+
+template <typename V>
+static void check_1hz_pass()
+{
+    const size_t n = 2000;
+    V v;
+    fill_tone(1.0f, n);
+    v.run(in_buf, out_buf, n);
+    float gain = rms_range(out_buf, 500, n) / (rms_range(in_buf, 500, n) + 1e-12f);
+    zassert_true(gain > 0.7f && gain < 1.1f, "%s: 1Hz gain out of range: %f",
+                 V::name, (double)gain);
+}
+
+template <typename V>
+static void check_10hz_atten()
+{
+    const size_t n = 2000;
+    V v1;
+    fill_tone(1.0f, n);
+    v1.run(in_buf, out_buf, n);
+    float out1_rms = rms_range(out_buf, n - 1500, n);
+
+    V v10;
+    fill_tone(10.0f, n);
+    v10.run(in_buf, out_buf, n);
+    float out10_rms = rms_range(out_buf, n - 1500, n);
+
+    float rel = out10_rms / (out1_rms + 1e-12f);
+    zassert_true(rel <= 0.5f, "%s: 10Hz attenuation too small, rel=%.3f",
+                 V::name, (double)rel);
+}
+
+ZTEST_SUITE(hr_filter_fixed, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hr_filter_fixed, test_dc_reject)
+{
+    check_dc_reject<FloatVariant>();
+    check_dc_reject<Q31Variant>();
+    check_dc_reject<Q15Variant>();
+}
+
+ZTEST(hr_filter_fixed, test_1hz_pass)
+{
+    check_1hz_pass<FloatVariant>();
+    check_1hz_pass<Q31Variant>();
+    check_1hz_pass<Q15Variant>();
+}
+
+ZTEST(hr_filter_fixed, test_10hz_atten)
+{
+    check_10hz_atten<FloatVariant>();
+    check_10hz_atten<Q31Variant>();
+    check_10hz_atten<Q15Variant>();
+}
+
+ZTEST(hr_filter_fixed, test_q31_tracks_float)
+{
+    /* Realistic PPG: large DC plus a small pulsatile component */
+    FloatVariant f;
+    Q31Variant q;
+    static float ref[N];
+    for (size_t i = 0; i < N; ++i) {
+        in_buf[i] = 0.5f + 0.01f * sinf(2.0f * PI * 1.2f * (float)i / FS);
+    }
+    f.run(in_buf, ref, N);
+    q.run(in_buf, out_buf, N);
+    float max_err = 0.0f;
+    for (size_t i = 0; i < N; ++i) {
+        float d = fabsf(ref[i] - out_buf[i]);
+        if (d > max_err) max_err = d;
+    }
+    zassert_true(max_err < 1e-4f, "Q31 deviates from float: %f", (double)max_err);
+}
+
+ZTEST(hr_filter_fixed, test_saturates_instead_of_wrapping)
+{
+    BiquadCascadeQ31<3> c;
+    BiquadCascadeDF2T<3> p;
+    hr_filter_load(p);
+    c.setCoeffs(p);
+    /* Full-scale square wave drives the HP transients past full scale */
+    int32_t prev = 0;
+    for (int i = 0; i < 400; ++i) {
+        int32_t x = ((i / 50) & 1) ? INT32_MIN : INT32_MAX;
+        int32_t y = c.process(x);
+        /* A wrap would show up as a sign flip of nearly full-scale size */
+        int64_t step = (int64_t)y - (int64_t)prev;
+        zassert_true(step < ((int64_t)1 << 32) - ((int64_t)1 << 28) &&
+                     step > -((int64_t)1 << 32) + ((int64_t)1 << 28),
+                     "wrap-around at %d", i);
+        prev = y;
+    }
+}
+
+ZTEST(hr_filter_fixed, test_rebase_keeps_output)
+{
+    /* HrFilter's fixed-point path quantizes the input less a tracked level
+     * and rebases the states when the level moves; the output must be that
+     * of the unshifted input */
+    BiquadCascadeDF2T<3> p;
+    hr_filter_load(p);
+    BiquadCascadeQ31<3> ref, shifted;
+    ref.setCoeffs(p);
+    shifted.setCoeffs(p);
+    const float k = 2147483648.0f / TEST_FULL_SCALE;
+    int32_t level = 0;
+    float max_err = 0.0f;
+    for (size_t off = 0; off < N; off += 10) {
+        const float drift = 0.5f * sinf(2.0f * PI * 0.05f * (float)off / FS);
+        const int32_t next = (int32_t)(drift * k);
+        shifted.rebase(next - level);
+        level = next;
+        for (size_t i = off; i < off + 10; ++i) {
+            const int32_t x = (int32_t)((drift + 0.2f * sinf(2.0f * PI * 1.2f * (float)i / FS)) * k);
+            const float d = fabsf((float)ref.process(x) - (float)shifted.process(x - level)) / k;
+            if (d > max_err) max_err = d;
+        }
+    }
+    zassert_true(max_err < 1e-5f, "rebased output deviates by %f", (double)max_err);
+}
+
+ZTEST(hr_filter_fixed, test_bench_cycles_per_sample)
+{
+    static int32_t q31_in[N], q31_out[N];
+    static int16_t q15_in[N], q15_out[N];
+    fill_tone(1.0f, N);
+    for (size_t i = 0; i < N; ++i) {
+        q31_in[i] = q31_sat((int64_t)(in_buf[i] * (2147483648.0f / TEST_FULL_SCALE)));
+        q15_in[i] = (int16_t)(q31_in[i] >> 16);
+    }
+
+    FloatVariant f;
+    uint64_t f_cycles = bench_cycles([&] { f.c.processBuffer(in_buf, out_buf, N); });
+    Q31Variant q31;
+    uint64_t q31_cycles = bench_cycles([&] { q31.c.processBuffer(q31_in, q31_out, N); });
+    Q15Variant q15;
+    uint64_t q15_cycles = bench_cycles([&] { q15.c.processBuffer(q15_in, q15_out, N); });
+
+    TC_PRINT("HR band-pass (3 sections)\n");
+    BENCH_PRINT("  float", f_cycles, N);
+    BENCH_PRINT("  q31", q31_cycles, N);
+    BENCH_PRINT("  q15 data / q31 state", q15_cycles, N);
+}
@@ -0,0 +1,215 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_filter.h"
+#include "beat_detector.h"
+#include "spectral_hr.h"
+#include "ppg_synth.h"
+#include "bench_util.h"
+
+static constexpr HrFilterProfile PROFILES[] = {
+    HrFilterProfile::Full, HrFilterProfile::Biquad, HrFilterProfile::DcAverage,
+};
+static const char* const NAMES[] = { "full", "biquad", "dc+average" };
+
+static_assert(hr_filter_cost(HrFilterProfile::DcAverage).ops() <
+              hr_filter_cost(HrFilterProfile::Biquad).ops() &&
+              hr_filter_cost(HrFilterProfile::Biquad).ops() <
+              hr_filter_cost(HrFilterProfile::Full).ops(), "cost order");
+
+/* Steady-state gain at f_hz (RMS out / RMS in after 10 s) */
+static float gain_at(HrFilterProfile p, uint32_t fs, float f_hz)
+{
+    const float PI = 3.14159265358979323846f;
+    HrFilter f;
+    zassert_true(f.init(fs), "no table for %u Hz", fs);
+    f.setProfile(p);
+    double in2 = 0.0, out2 = 0.0;
+    const size_t total = 20 * fs;
+    for (size_t i = 0; i < total; ++i) {
+        const float x = sinf(2.0f * PI * f_hz * (float)i / (float)fs);
+        float y;
+        f.process(&x, &y, 1);
+        if (i >= total / 2) {
+            in2 += (double)x * x;
+            out2 += (double)y * y;
+        }
+    }
+    return (float)sqrt(out2 / in2);
+}
+
+ZTEST_SUITE(hr_filter_profile, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hr_filter_profile, test_profile_responses)
+{
+    const uint32_t fs_list[] = { 25, 50, 100 };
+    for (uint32_t fs : fs_list) {
+        const float stop = fs >= 50 ? 15.0f : 11.0f;
+        for (size_t k = 0; k < 3; ++k) {
+            const float wander = gain_at(PROFILES[k], fs, 0.05f);
+            const float pass = gain_at(PROFILES[k], fs, 1.5f);
+            const float noise = gain_at(PROFILES[k], fs, stop);
+            TC_PRINT("%3u Hz %-10s: 0.05 Hz %3d %%, 1.5 Hz %3d %%, %d Hz %3d %%\n", fs, NAMES[k],
+                     (int)(100 * wander), (int)(100 * pass), (int)stop, (int)(100 * noise));
+            zassert_within(pass, 1.0f, 0.25f, "%u Hz %s: pass-band gain %d %%", fs, NAMES[k],
+                           (int)(100 * pass));
+            zassert_true(wander < 0.2f, "%u Hz %s: baseline gain %d %%", fs, NAMES[k],
+                         (int)(100 * wander));
+            zassert_true(noise < 0.6f, "%u Hz %s: %d Hz gain %d %%", fs, NAMES[k], (int)stop,
+                         (int)(100 * noise));
+        }
+    }
+
+    /* The moving average fits its ring up to the fastest table rate */
+    const float pass = gain_at(HrFilterProfile::DcAverage, 3200, 1.5f);
+    const float noise = gain_at(HrFilterProfile::DcAverage, 3200, 15.0f);
+    zassert_within(pass, 1.0f, 0.25f, "3200 Hz: pass-band gain %d %%", (int)(100 * pass));
+    zassert_true(noise < 0.6f, "3200 Hz: 15 Hz gain %d %%", (int)(100 * noise));
+}
+
+ZTEST(hr_filter_profile, test_runtime_switch)
+{
+    /* Raw counts: a pulse on a large DC level. Switching re-settles on the
+     * last input, so the DC level does not ring through the new profile */
+    PpgSynth ppg;
+    ppg.bpm = 70.0f;
+    HrFilter f;
+    zassert_true(f.init(50, ppg.dc), "no table for 50 Hz");
+    zassert_equal(f.profile(), HrFilterProfile::Full, "default profile");
+
+    float buf[10];
+    for (int round = 0; round < 6; ++round) {
+        const HrFilterProfile p = PROFILES[(round + 1) % 3];
+        f.setProfile(p);
+        zassert_true(f.profile() != p, "switched before a block");
+        float peak = 0.0f;
+        for (int blk = 0; blk < 25; ++blk) {
+            ppg.fill(buf, 10);
+            f.process(buf, buf, 10);
+            for (float v : buf) peak = fmaxf(peak, fabsf(v));
+        }
+        zassert_equal(f.profile(), p, "profile not applied");
+        zassert_true(peak < 2.0f * ppg.ac, "%s: transient %d after the switch", NAMES[(round + 1) % 3],
+                     (int)peak);
+    }
+
+    /* A rate change keeps the profile */
+    f.setProfile(HrFilterProfile::DcAverage);
+    zassert_true(f.setSampleRate(100), "no table for 100 Hz");
+    ppg.fill(buf, 10);
+    f.process(buf, buf, 10);
+    zassert_true(f.sampleRate() == 100 && f.profile() == HrFilterProfile::DcAverage,
+                 "rate switch lost the profile");
+    zassert_true(f.init(50), "no table for 50 Hz");
+    zassert_equal(f.profile(), HrFilterProfile::DcAverage, "init() reset the profile");
+}
+
+/* Reference signals for the accuracy side of the trade-off */
+struct Reference {
+    const char* name;
+    float bpm;
+    float noise;            /* uniform, counts */
+    float drift;            /* 0.08 Hz baseline swing, counts */
+    float hum;              /* 11 Hz interference, counts */
+};
+
+static const Reference REFS[] = {
+    { "clean 50 BPM", 50.0f, 20.0f, 0.0f, 0.0f },
+    { "clean 120 BPM", 120.0f, 20.0f, 0.0f, 0.0f },
+    { "wander 75 BPM", 75.0f, 20.0f, 4000.0f, 0.0f },
+    { "noisy 90 BPM", 90.0f, 600.0f, 0.0f, 0.0f },
+    { "11 Hz 75 BPM", 75.0f, 20.0f, 0.0f, 700.0f },
+};
+
+/* Mean |error| of the detector and spectral estimates over the last 20 s
+ * of 30 s at 50 Hz */
+static float hr_error(HrFilterProfile p, const Reference& ref)
+{
+    const float PI = 3.14159265358979323846f;
+    static HrFilter f;
+    BeatDetector d;
+    SpectralHr s;
+    PpgSynth ppg;
+    ppg.bpm = ref.bpm;
+    ppg.noise = ref.noise;
+    zassert_true(f.init(50, ppg.dc) && s.init(50), "no table for 50 Hz");
+    f.setProfile(p);
+    d.init(50);
+
+    float buf[10];
+    float err = 0.0f;
+    uint32_t n = 0;
+    for (size_t off = 0; off < 1500; off += 10) {
+        ppg.fill(buf, 10);
+        for (size_t i = 0; i < 10; ++i) {
+            const float t = (float)(off + i) / 50.0f;
+            buf[i] += ref.drift * sinf(2.0f * PI * 0.08f * t) + ref.hum * sinf(2.0f * PI * 11.0f * t);
+        }
+        f.process(buf, buf, 10);
+        d.process(buf, 10);
+        s.process(buf, 10);
+        if (off < 500) {
+            continue;
+        }
+        float bpm;
+        SpectralHr::Estimate est;
+        err += d.bpm(bpm) ? fabsf(bpm - ref.bpm) : ref.bpm;
+        err += s.estimate(est) ? fabsf(est.bpm - ref.bpm) : ref.bpm;
+        n += 2;
+    }
+    return err / (float)n;
+}
+
+ZTEST(hr_filter_profile, test_bench_accuracy_and_cycles)
+{
+    static float raw[2000];
+    PpgSynth ppg;
+    ppg.noise = 20.0f;
+    ppg.fill(raw, 2000);
+
+    /* Fastest of a few rounds, the profiles taking turns within a round,
+     * so an interrupt or a clock change does not skew the figures. The
+     * order is checked on hr_filter_cost() at compile time; the measured
+     * cycles are printed only, a wall-clock order is flaky on a busy host */
+    static HrFilter f[3];
+    static float out[2000];
+    uint64_t best[3];
+    for (size_t k = 0; k < 3; ++k) {
+        zassert_true(f[k].init(50, raw[0]), "no table for 50 Hz");
+        f[k].setProfile(PROFILES[k]);
+        best[k] = UINT64_MAX;
+    }
+    for (int round = 0; round < 20; ++round) {
+        for (size_t k = 0; k < 3; ++k) {
+            const uint64_t cycles = bench_cycles([&] {
+                for (size_t off = 0; off < 2000; off += 10) {
+                    f[k].process(raw + off, out + off, 10);
+                }
+            });
+            if (cycles < best[k]) best[k] = cycles;
+        }
+    }
+
+    for (size_t k = 0; k < 3; ++k) {
+        const HrFilterCost cost = hr_filter_cost(PROFILES[k]);
+        TC_PRINT("%s, %u mul + %u add + %u mem per sample:\n", NAMES[k], cost.mul, cost.add,
+                 cost.mem);
+        BENCH_PRINT("  50 Hz, 10-sample blocks", best[k], 2000);
+
+        float worst = 0.0f;
+        for (const Reference& ref : REFS) {
+            const float err = hr_error(PROFILES[k], ref);
+            if (err > worst) worst = err;
+            TC_PRINT("  %-16s mean |error| %d.%d BPM\n", ref.name, (int)err,
+                     (int)(10 * err) % 10);
+        }
+        /* Every profile tracks a clean pulse; the full cascade holds up on
+         * all references, the cheaper ones trade that for cycles */
+        zassert_true(hr_error(PROFILES[k], REFS[0]) < 0.5f && hr_error(PROFILES[k], REFS[1]) < 0.5f,
+                     "%s misses a clean pulse", NAMES[k]);
+        if (PROFILES[k] == HrFilterProfile::Full) {
+            zassert_true(worst < 1.5f, "full cascade %d.%d BPM off", (int)worst,
+                         (int)(10 * worst) % 10);
+        }
+    }
+}
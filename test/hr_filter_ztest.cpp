@@ -97,3 +97,144 @@ ZTEST(hr_filter, test_10hz_atten)
     /* Expect significant attenuation vs. 1Hz (e.g., <= -6 dB) */
     zassert_true(rel <= 0.5f, "10Hz attenuation too small, rel=%.3f", (double)rel);
 }
+
+/* ---- Instance API ---- */
+
+static constexpr size_t INST_N = 1500;
+static float inst_a[INST_N];
+static float inst_b[INST_N];
+static float inst_ref_a[INST_N];
+static float inst_ref_b[INST_N];
+
+static void fill_ppg(float* v, size_t n, float dc, float f_hz, float fs)
+{
+    const float PI = 3.14159265358979323846f;
+    for (size_t i = 0; i < n; ++i) v[i] = dc + sinf(2.0f * PI * f_hz * (float)i / fs);
+}
+
+ZTEST(hr_filter, test_instances_are_independent)
+{
+    fill_ppg(inst_a, INST_N, 10.0f, 1.0f, 100.0f);
+    fill_ppg(inst_b, INST_N, -5.0f, 2.0f, 100.0f);
+
+    /* Reference: each stream alone */
+    HrFilter solo;
+    solo.process(inst_a, inst_ref_a, INST_N);
+    solo.init();
+    solo.process(inst_b, inst_ref_b, INST_N);
+
+    /* Interleave the two streams block by block on separate instances */
+    HrFilterBank<2> bank;
+    zassert_true(bank.init(100), "bank init failed");
+    for (size_t off = 0; off < INST_N; off += 50) {
+        bank[0].process(inst_a + off, inst_a + off, 50);
+        bank[1].process(inst_b + off, inst_b + off, 50);
+    }
+    for (size_t i = 0; i < INST_N; ++i) {
+        zassert_equal(inst_a[i], inst_ref_a[i], "stream A differs at %u", (unsigned)i);
+        zassert_equal(inst_b[i], inst_ref_b[i], "stream B differs at %u", (unsigned)i);
+    }
+}
+
+ZTEST(hr_filter, test_state_save_restore)
+{
+    HrFilter f;
+    HrFilter::State snap;
+    fill_ppg(inst_a, INST_N, 3.0f, 1.5f, 100.0f);
+
+    f.process(inst_a, inst_ref_a, 700);
+    f.save(snap);
+    f.process(inst_a + 700, inst_ref_a + 700, INST_N - 700);
+
+    /* Disturb, then roll back and replay the tail */
+    f.reset();
+    f.process(inst_b, inst_b, 100);
+    f.restore(snap);
+    f.process(inst_a + 700, inst_ref_b, INST_N - 700);
+
+    for (size_t i = 0; i < INST_N - 700; ++i) {
+        zassert_equal(inst_ref_b[i], inst_ref_a[700 + i], "replay differs at %u", (unsigned)i);
+    }
+}
+
+ZTEST(hr_filter, test_instance_rate)
+{
+    HrFilter f;
+    zassert_equal(f.sampleRate(), HR_FILTER_DEFAULT_RATE_HZ, "default rate");
+    zassert_false(f.init(123), "accepted 123 Hz");
+    zassert_true(f.setSampleRate(400), "400 Hz rejected");
+    /* Pending until the next block */
+    zassert_equal(f.sampleRate(), HR_FILTER_DEFAULT_RATE_HZ, "switched early");
+    float x = 0.0f;
+    f.process(&x, &x, 1);
+    zassert_equal(f.sampleRate(), 400u, "switch not applied");
+}
+
+/* ---- Fast-settling init ---- */
+
+static constexpr size_t SETTLE_PERIOD = 80;   /* 1.25 Hz @ 100 Hz */
+static constexpr size_t SETTLE_N = 3040;      /* 38 periods, 30.4 s */
+static_assert(SETTLE_N % SETTLE_PERIOD == 0, "the steady-state reference replays whole periods");
+static float settle_in[SETTLE_N];
+static float settle_out[SETTLE_N];
+static float settle_ref[SETTLE_N];
+
+/* Raw RED-like PPG: large DC offset, small pulsatile component */
+static float raw_ppg(size_t i)
+{
+    const float PI = 3.14159265358979323846f;
+    return 100000.0f + 1000.0f * sinf(2.0f * PI * (float)(i % SETTLE_PERIOD) / (float)SETTLE_PERIOD);
+}
+
+/* Index after which |out - steady state| stays below tol */
+static size_t settling_samples(HrFilter& f, float tol)
+{
+    for (size_t i = 0; i < SETTLE_N; ++i) settle_in[i] = raw_ppg(i);
+    f.process(settle_in, settle_out, SETTLE_N);
+    size_t last_bad = 0;
+    for (size_t i = 0; i < SETTLE_N; ++i) {
+        if (fabsf(settle_out[i] - settle_ref[i]) > tol) last_bad = i + 1;
+    }
+    return last_bad;
+}
+
+ZTEST(hr_filter, test_settles_within_one_second)
+{
+    /* Steady-state response: run a whole number of periods first */
+    HrFilter ref;
+    for (size_t i = 0; i < SETTLE_N; ++i) settle_in[i] = raw_ppg(i);
+    ref.init(100, settle_in[0]);
+    for (int k = 0; k < 4; ++k) ref.process(settle_in, settle_ref, SETTLE_N);
+
+    /* Within 20 % of the pulse amplitude the beats are clearly detectable; the
+     * remaining error is the high-pass response to the pulse itself starting */
+    const float tol = 200.0f;
+
+    HrFilter f;
+    zassert_true(f.init(100, raw_ppg(0)), "init with initial sample failed");
+    size_t fast = settling_samples(f, tol);
+    zassert_true(fast < 100, "preloaded filter settled after %u samples", (unsigned)fast);
+
+    /* Zero state rings on the 100k DC offset for much longer. Fixed-point
+     * builds cannot hold that step and settle on the first input instead */
+    f.init(100);
+    size_t slow = settling_samples(f, tol);
+#if defined(CONFIG_HR_FILTER_Q31) || defined(CONFIG_HR_FILTER_Q15)
+    zassert_true(slow < 100, "zero-state settled after %u samples", (unsigned)slow);
+#else
+    zassert_true(slow > 10 * fast, "zero-state settled after %u samples", (unsigned)slow);
+#endif
+    TC_PRINT("settling: %u samples preloaded, %u from zero\n", (unsigned)fast, (unsigned)slow);
+
+    /* Re-settle after a finger lift: the new DC level must not ring either */
+    f.settle(raw_ppg(0));
+    size_t again = settling_samples(f, tol);
+    zassert_true(again < 100, "re-settled filter took %u samples", (unsigned)again);
+
+    /* Legacy entry point */
+    hr_filter_init(raw_ppg(0));
+    hr_filter_process(settle_in, settle_out, SETTLE_N);
+    for (size_t i = 100; i < SETTLE_N; ++i) {
+        zassert_within(settle_out[i], settle_ref[i], tol, "legacy init at %u", (unsigned)i);
+    }
+}
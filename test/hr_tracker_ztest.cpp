@@ -0,0 +1,159 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_tracker.h"
+#include "beat_detector.h"
+#include "spectral_hr.h"
+#include "autocorr_hr.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr float DT = 0.2f;   /* one HR thread block */
+
+static void feed(HrTracker& t, float seconds, float bpm, float conf)
+{
+    HrCandidate c = { bpm, conf };
+    for (float s = 0.0f; s < seconds; s += DT) t.update(DT, &c, 1);
+}
+
+ZTEST_SUITE(hr_tracker, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hr_tracker, test_converges_and_variance_shrinks)
+{
+    HrTracker t;
+    zassert_false(t.valid(), "valid before any candidate");
+
+    HrCandidate weak = { 80.0f, 0.2f };
+    t.update(DT, &weak, 1);
+    zassert_false(t.tracking(), "started on a low-confidence candidate");
+
+    feed(t, 1.0f, 72.0f, 0.9f);
+    zassert_true(t.valid(), "not valid after 1 s of confident candidates");
+    float v1 = t.variance();
+    feed(t, 10.0f, 72.0f, 0.9f);
+    zassert_within(t.bpm(), 72.0f, 0.5f, "tracked %d BPM", (int)t.bpm());
+    zassert_true(t.variance() < v1, "variance did not shrink");
+}
+
+ZTEST(hr_tracker, test_starts_on_most_confident)
+{
+    /* A harmonic listed first must not seed the track over a confident
+     * estimate behind it */
+    HrTracker t;
+    const HrCandidate c[] = { { 144.0f, 0.35f }, { 72.0f, 0.9f } };
+    t.update(DT, c, 2);
+    zassert_true(t.tracking(), "no track started");
+    zassert_within(t.bpm(), 72.0f, 0.5f, "started on %d BPM", (int)t.bpm());
+}
+
+ZTEST(hr_tracker, test_rejects_impossible_jumps)
+{
+    HrTracker t;
+    feed(t, 10.0f, 70.0f, 0.9f);
+
+    /* A doubled estimate (harmonic lock) for one window, then a wild one */
+    HrCandidate spike[2] = { { 140.0f, 0.9f }, { 35.0f, 0.9f } };
+    size_t acc = t.update(DT, spike, 2);
+    zassert_equal(acc, 0u, "accepted %u impossible candidates", (unsigned)acc);
+    zassert_within(t.bpm(), 70.0f, 1.0f, "jumped to %d BPM", (int)t.bpm());
+
+    /* Disagreeing candidates are outvoted by agreeing ones */
+    HrCandidate mix[3] = { { 71.0f, 0.8f }, { 118.0f, 0.9f }, { 70.0f, 0.6f } };
+    for (int i = 0; i < 20; ++i) t.update(DT, mix, 3);
+    zassert_within(t.bpm(), 70.5f, 1.5f, "pulled to %d BPM", (int)t.bpm());
+}
+
+ZTEST(hr_tracker, test_follows_ramp)
+{
+    /* 60 -> 120 BPM over 60 s (exercise onset) */
+    HrTracker t;
+    feed(t, 5.0f, 60.0f, 0.8f);
+    float bpm = 60.0f;
+    float worst = 0.0f;
+    for (int i = 0; i < 300; ++i) {
+        bpm += 1.0f * DT;
+        HrCandidate c = { bpm, 0.8f };
+        t.update(DT, &c, 1);
+        float err = fabsf(t.bpm() - bpm);
+        if (i > 25 && err > worst) worst = err;
+    }
+    zassert_true(worst < 2.0f, "lag behind ramp up to %d.%02d BPM",
+                 (int)worst, (int)(worst * 100.0f) % 100);
+    zassert_within(t.slope(), 1.0f, 0.3f, "slope estimate off");
+}
+
+ZTEST(hr_tracker, test_reacquires_after_sustained_disagreement)
+{
+    HrTracker t;
+    feed(t, 10.0f, 60.0f, 0.9f);
+    /* Real step beyond MAX_JUMP_BPM (e.g. first lock was a sub-harmonic) */
+    feed(t, HrTracker::REACQUIRE_S - 1.0f, 120.0f, 0.9f);
+    zassert_within(t.bpm(), 60.0f, 5.0f, "followed the step too early");
+    feed(t, 2.0f, 120.0f, 0.9f);
+    zassert_within(t.bpm(), 120.0f, 2.0f, "did not reacquire, at %d BPM", (int)t.bpm());
+}
+
+ZTEST(hr_tracker, test_expires_without_input)
+{
+    HrTracker t;
+    feed(t, 10.0f, 75.0f, 0.9f);
+    zassert_true(t.valid(), "not valid");
+    for (int i = 0; i < 100; ++i) t.update(DT, NULL, 0);
+    zassert_false(t.valid(), "still valid after 20 s without candidates");
+}
+
+ZTEST(hr_tracker, test_confidence_weighting)
+{
+    HrTracker a, b;
+    feed(a, 10.0f, 70.0f, 0.9f);
+    feed(b, 10.0f, 70.0f, 0.9f);
+    HrCandidate hi = { 76.0f, 1.0f }, lo = { 76.0f, 0.3f };
+    a.update(DT, &hi, 1);
+    b.update(DT, &lo, 1);
+    zassert_true(a.bpm() - 70.0f > 2.0f * (b.bpm() - 70.0f),
+                 "low confidence moved the track as much as high");
+}
+
+ZTEST(hr_tracker, test_fuses_estimators_on_noisy_ppg)
+{
+    PpgSynth ppg;
+    ppg.bpm = 78.0f;
+    ppg.ac = 300.0f;
+    ppg.noise = 150.0f;
+    HrFilter f;
+    BeatDetector d;
+    SpectralHr s;
+    AutocorrHr a;
+    HrTracker t;
+    f.init(50, ppg.dc);
+    d.init(50);
+    s.init(50);
+    a.init(50);
+
+    float buf[10];
+    float worst = 0.0f;
+    for (int blk = 0; blk < 5 * 60; ++blk) {        /* 60 s */
+        ppg.fill(buf, 10);
+        f.process(buf, buf, 10);
+        d.process(buf, 10);
+        s.process(buf, 10);
+        a.process(buf, 10);
+
+        HrCandidate c[3];
+        size_t n = 0;
+        float bpm;
+        SpectralHr::Estimate se;
+        AutocorrHr::Estimate ae;
+        if (d.bpm(bpm)) c[n++] = { bpm, d.confidence() };
+        if (s.estimate(se)) c[n++] = { se.bpm, se.confidence };
+        if (a.estimate(ae)) c[n++] = { ae.bpm, ae.score };
+        t.update(DT, c, n);
+
+        if (blk > 5 * 15 && t.valid()) {
+            float err = fabsf(t.bpm() - 78.0f);
+            if (err > worst) worst = err;
+        }
+    }
+    zassert_true(t.valid(), "no valid track");
+    zassert_true(worst < 3.0f, "tracked value strayed %d BPM", (int)worst);
+}
@@ -0,0 +1,171 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hrv_window.h"
+
+/* RR series around 800 ms: slow drift plus beat-to-beat jitter, steps well
+ * inside the ectopic limit */
+struct RrSynth {
+    uint32_t seed = 777u;
+    float base = 800.0f;
+    float t = 0.0f;
+
+    uint16_t next()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const float jitter = 40.0f * ((float)(seed >> 8) / 16777216.0f - 0.5f);
+        t += 1.0f;
+        return (uint16_t)(base + 60.0f * sinf(0.05f * t) + jitter);
+    }
+};
+
+/* Textbook metrics over the largest suffix of rr[] that fits window_ms;
+ * pair[i] tells whether rr[i] followed rr[i - 1] */
+static void reference(const uint16_t* rr, const bool* pair, size_t n, uint32_t window_ms,
+                      float& rmssd, float& sdnn, float& pnn50, size_t& count)
+{
+    size_t first = n;
+    uint32_t sum = 0;
+    while (first > 0 && (sum + rr[first - 1] <= window_ms || first == n)) {
+        sum += rr[--first];
+    }
+    count = n - first;
+
+    double mean = 0.0;
+    for (size_t i = first; i < n; ++i) mean += rr[i];
+    mean /= (double)count;
+    double var = 0.0;
+    for (size_t i = first; i < n; ++i) var += (rr[i] - mean) * (rr[i] - mean);
+    sdnn = (float)sqrt(var / (double)(count - 1));
+
+    double sq = 0.0;
+    size_t pairs = 0, big = 0;
+    for (size_t i = first + 1; i < n; ++i) {
+        if (!pair[i]) continue;
+        const int d = (int)rr[i] - (int)rr[i - 1];
+        sq += (double)d * d;
+        ++pairs;
+        if (d > 50 || d < -50) ++big;
+    }
+    rmssd = (float)sqrt(sq / (double)pairs);
+    pnn50 = 100.0f * (float)big / (float)pairs;
+}
+
+ZTEST_SUITE(hrv_window, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(hrv_window, test_matches_rescan)
+{
+    static uint16_t rr[3000];
+    static bool pair[3000];
+    RrSynth synth;
+    HrvWindow<512> w;
+    w.init(120000);
+
+    for (size_t i = 0; i < 3000; ++i) {
+        rr[i] = synth.next();
+        /* A gap every 97 beats, like a detector restart */
+        const bool successive = (i % 97) != 0;
+        pair[i] = successive && i > 0;
+        w.add(rr[i], successive);
+
+        if (i % 500 == 499) {
+            float rmssd, sdnn, pnn50;
+            size_t count;
+            reference(rr, pair, i + 1, 120000, rmssd, sdnn, pnn50, count);
+            HrvWindow<512>::Metrics m;
+            zassert_true(w.metrics(m), "no metrics after %u intervals", (unsigned)(i + 1));
+            zassert_equal(m.intervals, count, "window holds %u, expected %u",
+                          m.intervals, (unsigned)count);
+            zassert_within(m.rmssd_ms, rmssd, 0.01f, "RMSSD %d vs %d",
+                           (int)m.rmssd_ms, (int)rmssd);
+            zassert_within(m.sdnn_ms, sdnn, 0.01f, "SDNN %d vs %d", (int)m.sdnn_ms, (int)sdnn);
+            zassert_within(m.pnn50_pct, pnn50, 0.01f, "pNN50 %d vs %d",
+                           (int)m.pnn50_pct, (int)pnn50);
+        }
+    }
+}
+
+ZTEST(hrv_window, test_known_values)
+{
+    /* Alternating 800/900 ms: every difference is 100 ms */
+    HrvWindow<64> w;
+    w.init(60000);
+    for (int i = 0; i < 40; ++i) {
+        w.add(i & 1 ? 900 : 800, true);
+    }
+    HrvWindow<64>::Metrics m;
+    zassert_true(w.metrics(m), "no metrics");
+    zassert_within(m.rmssd_ms, 100.0f, 0.01f, "RMSSD %d", (int)m.rmssd_ms);
+    zassert_within(m.sdnn_ms, 50.0f * sqrtf(40.0f / 39.0f), 0.01f, "SDNN %d", (int)m.sdnn_ms);
+    zassert_within(m.pnn50_pct, 100.0f, 0.01f, "pNN50 %d", (int)m.pnn50_pct);
+    zassert_within(m.mean_rr_ms, 850.0f, 0.01f, "mean RR %d", (int)m.mean_rr_ms);
+}
+
+ZTEST(hrv_window, test_window_and_capacity)
+{
+    /* 10 s of 800 ms intervals is 12 of them */
+    HrvWindow<64> w;
+    w.init(10000);
+    for (int i = 0; i < 100; ++i) w.add(800, true);
+    zassert_equal(w.size(), 12u, "time window holds %u", (unsigned)w.size());
+
+    /* A short ring caps the window before the time does */
+    HrvWindow<16> small;
+    small.init(60000);
+    for (int i = 0; i < 100; ++i) small.add(800, true);
+    zassert_equal(small.size(), 16u, "ring holds %u", (unsigned)small.size());
+    HrvWindow<16>::Metrics m;
+    zassert_true(small.metrics(m), "no metrics");
+    zassert_equal(m.pairs, 15u, "%u pairs in a full ring", m.pairs);
+}
+
+ZTEST(hrv_window, test_rejects_ectopic_and_gaps)
+{
+    HrvWindow<64> w;
+    w.init(60000);
+    for (int i = 0; i < 20; ++i) w.add(800, true);
+    w.add(500, true);              /* premature beat */
+    w.add(1100, true);             /* compensatory pause */
+    w.add(800, true);              /* no predecessor: not a pair */
+    for (int i = 0; i < 5; ++i) w.add(800, true);
+    w.add(850, false);             /* after a gap: not a pair */
+    w.add(100, true);              /* implausible */
+
+    HrvWindow<64>::Metrics m;
+    zassert_true(w.metrics(m), "no metrics");
+    zassert_equal(m.intervals, 27u, "%u intervals kept", m.intervals);
+    zassert_equal(m.pairs, 24u, "%u pairs", m.pairs);
+    zassert_within(m.rmssd_ms, 0.0f, 0.01f, "ectopic beats leaked into RMSSD (%d ms)",
+                   (int)m.rmssd_ms);
+
+    w.reset();
+    zassert_false(w.metrics(m), "metrics after reset");
+    zassert_equal(w.windowMs(), 60000u, "window lost on reset");
+}
+
+ZTEST(hrv_window, test_follows_a_step_change)
+{
+    /* Exercise onset: a lasting 25 % step is a new rhythm, not an ectopic
+     * run; the window re-anchors after two intervals that agree */
+    HrvWindow<256> w;
+    w.init(600000);
+    for (int i = 0; i < 30; ++i) w.add(1000, true);
+    for (int i = 0; i < 200; ++i) w.add(750, true);
+
+    HrvWindow<256>::Metrics m;
+    zassert_true(w.metrics(m), "no metrics");
+    zassert_equal(m.intervals, 229u, "%u intervals kept", m.intervals);
+    zassert_equal(m.pairs, 227u, "%u pairs", m.pairs);
+    zassert_within(m.mean_rr_ms, (30.0f * 1000.0f + 199.0f * 750.0f) / 229.0f, 0.01f,
+                   "mean RR %d", (int)m.mean_rr_ms);
+    zassert_within(m.rmssd_ms, 0.0f, 0.01f, "the step leaked into RMSSD (%d ms)",
+                   (int)m.rmssd_ms);
+
+    /* Two rejected intervals that disagree are still dropped */
+    for (int i = 0; i < 10; ++i) w.add(750, true);
+    w.add(450, true);
+    w.add(1000, true);
+    w.add(750, true);
+    zassert_true(w.metrics(m), "no metrics");
+    zassert_equal(m.intervals, 240u, "%u intervals kept", m.intervals);
+}
@@ -0,0 +1,174 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "motion_canceller.h"
+#include "spectral_hr.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+#include "bench_util.h"
+
+static constexpr uint32_t FS = 50;
+static constexpr size_t BLOCK = 10;
+static constexpr float PI_F = 3.14159265358979323846f;
+
+/* Wrist accelerometer while walking: step rate plus harmonic, different
+ * mix per axis, gravity on z, a little sensor noise (m/s^2) */
+struct WalkSynth {
+    float step_hz = 1.8f;
+    float amp = 3.0f;
+    float t = 0.0f;
+    uint32_t seed = 4242u;
+
+    float noise()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return 0.02f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+    }
+
+    void next(float out[3])
+    {
+        const float p = 2.0f * PI_F * step_hz * t;
+        out[0] = amp * (sinf(p) + 0.4f * sinf(2.0f * p + 0.7f)) + noise();
+        out[1] = amp * (0.6f * cosf(p) + 0.3f * sinf(2.0f * p)) + noise();
+        out[2] = 9.81f + amp * 0.5f * sinf(p + 1.2f) + noise();
+        t += 1.0f / (float)FS;
+    }
+};
+
+/* Motion artifact in PPG counts: a short FIR of the axes (sensor shifting
+ * on the skin lags the acceleration a little) */
+struct ArtifactPath {
+    float gain = 200.0f;          /* counts per m/s^2 */
+    float prev[3][2] = {};
+
+    float next(const float a[3])
+    {
+        float v = gain * (0.8f * a[0] + 0.5f * prev[0][0] - 0.3f * prev[1][1]
+                          + 0.6f * a[1] + 0.4f * prev[2][0]);
+        for (int k = 0; k < 3; ++k) {
+            prev[k][1] = prev[k][0];
+            prev[k][0] = a[k];
+        }
+        return v;
+    }
+};
+
+struct Result {
+    float snr_in_db;
+    float snr_out_db;
+    float bpm_in;
+    float bpm_out;
+};
+
+/* Clean PPG, PPG with motion and the three axes, each through its own
+ * band-pass; the canceller sees the noisy PPG and the axes. SNRs against
+ * the filtered clean PPG over the last `measure_s` seconds. */
+template <size_t Taps>
+static Result run(float seconds, float measure_s, float motion_amp)
+{
+    PpgSynth ppg;
+    ppg.bpm = 75.0f;
+    ppg.ac = 1000.0f;
+    WalkSynth walk;
+    walk.amp = motion_amp;
+    ArtifactPath path;
+    HrFilter f_clean, f_noisy;
+    HrFilterBank<3> f_acc;
+    MotionCanceller<Taps> mc;
+    SpectralHr s_in, s_out;
+    f_clean.init(FS, ppg.dc);
+    f_noisy.init(FS, ppg.dc);
+    f_acc.init(FS);
+    f_acc[2].settle(9.81f);
+    s_in.init(FS);
+    s_out.init(FS);
+
+    float sig = 0.0f, err_in = 0.0f, err_out = 0.0f;
+    const size_t total = (size_t)(seconds * FS);
+    const size_t from = total - (size_t)(measure_s * FS);
+    for (size_t off = 0; off < total; off += BLOCK) {
+        float clean[BLOCK], noisy[BLOCK], in[BLOCK], acc[BLOCK][3];
+        for (size_t i = 0; i < BLOCK; ++i) {
+            clean[i] = ppg.next();
+            walk.next(acc[i]);
+            noisy[i] = clean[i] + path.next(acc[i]);
+        }
+        f_clean.process(clean, clean, BLOCK);
+        f_noisy.process(noisy, noisy, BLOCK);
+        for (size_t k = 0; k < 3; ++k) {
+            f_acc[k].process(&acc[0][k], 3, &acc[0][k], 3, BLOCK);
+        }
+        for (size_t i = 0; i < BLOCK; ++i) in[i] = noisy[i];
+        mc.process(noisy, &acc[0][0], BLOCK);
+        s_in.process(in, BLOCK);
+        s_out.process(noisy, BLOCK);
+
+        if (off >= from) {
+            for (size_t i = 0; i < BLOCK; ++i) {
+                sig += clean[i] * clean[i];
+                err_in += (in[i] - clean[i]) * (in[i] - clean[i]);
+                err_out += (noisy[i] - clean[i]) * (noisy[i] - clean[i]);
+            }
+        }
+    }
+
+    Result r;
+    r.snr_in_db = 10.0f * log10f(sig / (err_in + 1e-9f));
+    r.snr_out_db = 10.0f * log10f(sig / (err_out + 1e-9f));
+    SpectralHr::Estimate e;
+    r.bpm_in = s_in.estimate(e) ? e.bpm : 0.0f;
+    r.bpm_out = s_out.estimate(e) ? e.bpm : 0.0f;
+    return r;
+}
+
+ZTEST_SUITE(motion_canceller, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(motion_canceller, test_cancels_correlated_motion)
+{
+    Result r = run<8>(60.0f, 20.0f, 3.0f);
+    TC_PRINT("walking: SNR %d dB -> %d dB (+%d dB), HR %d -> %d BPM\n",
+             (int)r.snr_in_db, (int)r.snr_out_db, (int)(r.snr_out_db - r.snr_in_db),
+             (int)r.bpm_in, (int)r.bpm_out);
+    zassert_true(r.snr_in_db < 0.0f, "motion too weak to test (%d dB)", (int)r.snr_in_db);
+    zassert_true(r.snr_out_db - r.snr_in_db > 15.0f, "SNR improved only %d dB",
+                 (int)(r.snr_out_db - r.snr_in_db));
+    zassert_within(r.bpm_out, 75.0f, 3.0f, "HR after cancelling %d BPM", (int)r.bpm_out);
+}
+
+ZTEST(motion_canceller, test_tap_counts)
+{
+    /* The artifact path spans 3 samples; shorter filters do what they can */
+    Result r2 = run<2>(60.0f, 20.0f, 3.0f);
+    Result r4 = run<4>(60.0f, 20.0f, 3.0f);
+    Result r16 = run<16>(60.0f, 20.0f, 3.0f);
+    TC_PRINT("taps 2/4/16: +%d/+%d/+%d dB\n", (int)(r2.snr_out_db - r2.snr_in_db),
+             (int)(r4.snr_out_db - r4.snr_in_db), (int)(r16.snr_out_db - r16.snr_in_db));
+    zassert_true(r4.snr_out_db - r4.snr_in_db > 15.0f, "4 taps +%d dB",
+                 (int)(r4.snr_out_db - r4.snr_in_db));
+    zassert_true(r16.snr_out_db - r16.snr_in_db > 15.0f, "16 taps +%d dB",
+                 (int)(r16.snr_out_db - r16.snr_in_db));
+}
+
+ZTEST(motion_canceller, test_leaves_still_ppg_alone)
+{
+    Result r = run<8>(30.0f, 20.0f, 0.0f);
+    zassert_true(r.snr_out_db > 30.0f, "still PPG distorted: SNR %d dB", (int)r.snr_out_db);
+}
+
+ZTEST(motion_canceller, test_bench_cycles_per_sample)
+{
+    static float ppg[1000];
+    static float acc[1000][3];
+    PpgSynth p;
+    WalkSynth walk;
+    p.fill(ppg, 1000);
+    for (auto &a : acc) walk.next(a);
+
+    MotionCanceller<8> mc8;
+    uint64_t c8 = bench_cycles([&] { mc8.process(ppg, &acc[0][0], 1000); });
+    BENCH_PRINT("  NLMS 3 axes x 8 taps", c8, 1000);
+
+    MotionCanceller<16> mc16;
+    uint64_t c16 = bench_cycles([&] { mc16.process(ppg, &acc[0][0], 1000); });
+    BENCH_PRINT("  NLMS 3 axes x 16 taps", c16, 1000);
+}
@@ -0,0 +1,196 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+#include <string.h>
+
+#include "hr_pipeline.h"
+#include "ppg_synth.h"
+#include "bench_util.h"
+
+static constexpr size_t BLOCK = 24;        /* HR_BLOCK_MAX */
+
+/* RAM is part of the type */
+static_assert(HrOnlyPipeline<BLOCK>::BUFFER_BYTES == BLOCK * sizeof(float), "block size");
+static_assert(HrOnlyPipeline<BLOCK>::STATE_BYTES ==
+              sizeof(DecimateStage<>) + sizeof(BandPassStage) + sizeof(DetectStage) +
+              sizeof(SpectralStage) + sizeof(AutocorrStage), "stage state");
+static_assert(HrMotionPipeline<BLOCK, 8>::STAGES == 6, "motion variant stages");
+
+/* The same chain wired by hand, as heart_rate.cpp did */
+struct HandWired {
+    PolyphaseDecimator<> decimator;
+    HrFilter filter;
+    BeatDetector detector;
+    SpectralHr spectral;
+    AutocorrHr autocorr;
+    uint32_t factor = 1;
+
+    bool init(uint32_t fs, uint32_t target)
+    {
+        factor = hr_filter_decimation(fs, target, 32);
+        const uint32_t rate = fs / factor;
+        if (factor > 1 && !decimator.init(factor)) {
+            return false;
+        }
+        detector.init(rate);
+        return filter.init(rate) && spectral.init(rate) && autocorr.init(rate);
+    }
+
+    void settle(float x)
+    {
+        if (factor > 1) {
+            decimator.settle(x);
+        }
+        filter.settle(x);
+    }
+
+    size_t run(float* x, size_t n)
+    {
+        if (factor > 1) {
+            n = decimator.process(x, n, x);
+        }
+        filter.process(x, x, n);
+        detector.process(x, n);
+        spectral.process(x, n);
+        autocorr.process(x, n);
+        return n;
+    }
+};
+
+ZTEST_SUITE(pipeline, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(pipeline, test_rate_propagation)
+{
+    static HrOnlyPipeline<BLOCK> p;
+
+    zassert_true(p.init(400, 50), "400 Hz not supported");
+    zassert_equal(p.stage<0>().factor(), 8, "factor %u", p.stage<0>().factor());
+    zassert_equal(p.rate(), 50, "rate %u", p.rate());
+    zassert_equal(p.stage<2>().detector.sampleRate(), 50, "detector at %u Hz",
+                  p.stage<2>().detector.sampleRate());
+
+    zassert_true(p.init(50, 50), "50 Hz not supported");
+    zassert_equal(p.stage<0>().factor(), 1, "decimating at the target rate");
+    zassert_equal(p.rate(), 50, "rate %u", p.rate());
+
+    zassert_false(p.init(7, 50), "7 Hz accepted");
+    zassert_equal(p.rate(), 0, "rate kept after a failed init");
+}
+
+ZTEST(pipeline, test_matches_hand_wired)
+{
+    const uint32_t fs_list[] = { 50, 400 };
+    for (uint32_t fs : fs_list) {
+        static HrOnlyPipeline<BLOCK> p;
+        static HandWired h;
+        zassert_true(p.init(fs, 50) && h.init(fs, 50), "%u Hz not supported", fs);
+
+        PpgSynth ppg;
+        ppg.fs = (float)fs;
+        ppg.bpm = 72.0f;
+        ppg.noise = 20.0f;
+        PpgSynth probe = ppg;
+        const float first = probe.next();
+        p.settle(first);
+        h.settle(first);
+
+        const size_t total = 20 * fs;
+        for (size_t off = 0; off < total; off += BLOCK) {
+            float ref[BLOCK];
+            const size_t n = total - off < BLOCK ? total - off : BLOCK;
+            ppg.fill(ref, n);
+            memcpy(p.data(), ref, n * sizeof(float));
+            const size_t out = p.run(n);
+            zassert_equal(out, h.run(ref, n), "%u Hz: block lengths differ", fs);
+            zassert_mem_equal(p.data(), ref, out * sizeof(float), "%u Hz: output differs", fs);
+        }
+
+        float a, b;
+        zassert_true(p.stage<2>().detector.bpm(a) && h.detector.bpm(b), "%u Hz: no BPM", fs);
+        zassert_equal(a, b, "%u Hz: detector differs", fs);
+        SpectralHr::Estimate sa, sb;
+        zassert_true(p.stage<3>().spectral.estimate(sa) && h.spectral.estimate(sb),
+                     "%u Hz: no spectral estimate", fs);
+        zassert_equal(sa.bpm, sb.bpm, "%u Hz: spectral estimate differs", fs);
+        zassert_within(a, 72.0f, 2.0f, "%u Hz: %d BPM", fs, (int)a);
+    }
+}
+
+ZTEST(pipeline, test_stage_ranges_and_spike_stage)
+{
+    /* Raw spikes first, then the front end; run in two halves */
+    static Pipeline<BLOCK, SpikeStage<>, DecimateStage<>, BandPassStage> p;
+    static HrFrontEnd<BLOCK> clean;
+    zassert_true(p.init(100, 50) && clean.init(100, 50), "100 Hz not supported");
+    zassert_equal(p.rate(), 50, "rate %u", p.rate());
+
+    PpgSynth ppg;
+    ppg.fs = 100.0f;
+    ppg.bpm = 60.0f;
+    PpgSynth twin = ppg;
+    p.settle(ppg.dc);
+    clean.settle(ppg.dc);
+
+    /* The spike filter delays by 3 samples, repeating the first: so does
+     * the reference */
+    float worst = 0.0f;
+    for (size_t off = 0; off < 2000; off += BLOCK) {
+        float* x = p.data();
+        ppg.fill(x, BLOCK);
+        for (size_t i = 0; i < BLOCK; ++i) {
+            if ((off + i) % 97 == 50) x[i] += 20000.0f;
+        }
+        size_t n = p.run<0, 1>(BLOCK);
+        zassert_equal(n, BLOCK, "spike stage changed the length");
+        n = p.run<1, 3>(n);
+
+        float* c = clean.data();
+        const size_t skip = off == 0 ? 3 : 0;
+        twin.fill(c + skip, BLOCK - skip);
+        for (size_t i = 0; i < skip; ++i) c[i] = c[skip];
+        const size_t m = clean.run(BLOCK);
+        zassert_equal(n, m, "lengths differ");
+        for (size_t i = 0; off > 400 && i < n; ++i) {
+            const float d = fabsf(p.data()[i] - c[i]);
+            if (d > worst) worst = d;
+        }
+    }
+    TC_PRINT("spikes through the front end: worst %d counts of 1000\n", (int)worst);
+    zassert_true(p.stage<0>().hampel.replaced >= 20, "%u spikes replaced",
+                 p.stage<0>().hampel.replaced);
+    zassert_true(worst < 50.0f, "spike residue %d", (int)worst);
+}
+
+ZTEST(pipeline, test_bench_cycles_per_sample)
+{
+    static HrOnlyPipeline<BLOCK> p;
+    static HandWired h;
+    zassert_true(p.init(400, 50) && h.init(400, 50), "400 Hz not supported");
+
+    PpgSynth ppg;
+    ppg.fs = 400.0f;
+    static float raw[4800];
+    ppg.fill(raw, 4800);
+    p.settle(raw[0]);
+    h.settle(raw[0]);
+
+    volatile float sink = 0.0f;
+    uint64_t c_pipe = bench_cycles([&] {
+        for (size_t off = 0; off < 4800; off += BLOCK) {
+            memcpy(p.data(), raw + off, BLOCK * sizeof(float));
+            sink = p.data()[p.run(BLOCK) - 1];
+        }
+    });
+    uint64_t c_hand = bench_cycles([&] {
+        float buf[BLOCK];
+        for (size_t off = 0; off < 4800; off += BLOCK) {
+            memcpy(buf, raw + off, BLOCK * sizeof(float));
+            sink = buf[h.run(buf, BLOCK) - 1];
+        }
+    });
+    (void)sink;
+    TC_PRINT("HR only, 400 -> 50 Hz, %u B block + %u B state:\n",
+             (unsigned)HrOnlyPipeline<BLOCK>::BUFFER_BYTES,
+             (unsigned)HrOnlyPipeline<BLOCK>::STATE_BYTES);
+    BENCH_PRINT("  Pipeline<...>", c_pipe, 4800);
+    BENCH_PRINT("  hand-wired", c_hand, 4800);
+}
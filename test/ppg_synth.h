@@ -0,0 +1,60 @@
+/*
+ * CareLoop - Synthetic PPG for ztest signal-processing tests
+ */
+#ifndef PPG_SYNTH_H
+#define PPG_SYNTH_H
+
+#include <math.h>
+#include <stdint.h>
+
+/*
+ * Pulse shape: systolic Gaussian plus a smaller dicrotic wave, scaled to the
+ * beat period, on a large DC offset like the raw MAX30102 counts. Optional
+ * respiratory amplitude modulation and uniform noise (deterministic LCG).
+ * Positive pulse = blood volume up.
+ */
+struct PpgSynth {
+    float fs = 50.0f;
+    float bpm = 60.0f;
+    float dc = 100000.0f;
+    float ac = 1000.0f;
+    float dicrotic = 0.4f;        /* relative to the systolic peak */
+    float resp_hz = 0.0f;         /* respiratory modulation rate */
+    float resp_depth = 0.0f;      /* +/- fraction of ac */
+    float noise = 0.0f;           /* +/- amplitude */
+
+    float phase = 0.0f;           /* beat phase, 0..1 */
+    float t = 0.0f;
+    uint32_t seed = 12345u;
+
+    static float gauss(float p, float mu, float sigma)
+    {
+        float d = (p - mu) / sigma;
+        return expf(-0.5f * d * d);
+    }
+
+    float rand_pm1()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 8388608.0f - 1.0f;
+    }
+
+    float next()
+    {
+        const float PI = 3.14159265358979323846f;
+        float wave = gauss(phase, 0.25f, 0.08f) + dicrotic * gauss(phase, 0.55f, 0.10f);
+        float mod = 1.0f + resp_depth * sinf(2.0f * PI * resp_hz * t);
+        float v = dc + ac * mod * wave + noise * rand_pm1();
+        phase += bpm / (60.0f * fs);
+        if (phase >= 1.0f) phase -= 1.0f;
+        t += 1.0f / fs;
+        return v;
+    }
+
+    void fill(float* v, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i) v[i] = next();
+    }
+};
+
+#endif /* PPG_SYNTH_H */
@@ -0,0 +1,119 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "respiration.h"
+#include "beat_detector.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr uint32_t FS = 50;
+static constexpr size_t BLOCK = 10;
+static constexpr float PI_F = 3.14159265358979323846f;
+
+/* Breathing at brpm on the PPG: amplitude (PpgSynth), baseline and heart
+ * rate (sinus arrhythmia) modulation, each optional */
+struct Breathing {
+    float brpm = 15.0f;
+    bool am = true, bm = true, fm = true;
+};
+
+/* The pipeline order of heart_rate.cpp: keep the raw block, band-pass in
+ * place, detector, new beats into the estimator */
+static RespirationEstimator::Estimate run(RespirationEstimator& r, const Breathing& b,
+                                          float seconds, bool& ok)
+{
+    PpgSynth ppg;
+    ppg.bpm = 70.0f;
+    ppg.resp_hz = b.brpm / 60.0f;
+    ppg.resp_depth = b.am ? 0.2f : 0.0f;
+    HrFilter f;
+    BeatDetector d;
+    PpgSynth probe = ppg;
+    f.init(FS, probe.next());
+    d.init(FS);
+    r.init(FS);
+
+    uint32_t seen = d.intervals();
+    float t = 0.0f;
+    const size_t total = (size_t)(seconds * FS);
+    for (size_t off = 0; off < total; off += BLOCK) {
+        float raw[BLOCK], buf[BLOCK];
+        for (size_t i = 0; i < BLOCK; ++i) {
+            const float breath = sinf(2.0f * PI_F * b.brpm / 60.0f * t);
+            if (b.fm) ppg.bpm = 70.0f + 5.0f * breath;
+            raw[i] = ppg.next() + (b.bm ? 300.0f * breath : 0.0f);
+            buf[i] = raw[i];
+            t += 1.0f / (float)FS;
+        }
+        f.process(buf, buf, BLOCK);
+        r.process(raw, buf, BLOCK);
+        d.process(buf, BLOCK);
+        for (size_t i = d.intervals() - seen; i-- > 0;) {
+            r.addBeat(d.rr(i), d.amplitude(i));
+        }
+        seen = d.intervals();
+    }
+    RespirationEstimator::Estimate e{};
+    ok = r.estimate(e);
+    return e;
+}
+
+ZTEST_SUITE(respiration, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(respiration, test_rates_6_to_30)
+{
+    const float rates[] = { 8, 12, 15, 20, 24 };
+    for (float brpm : rates) {
+        RespirationEstimator r;
+        Breathing b;
+        b.brpm = brpm;
+        bool ok;
+        RespirationEstimator::Estimate e = run(r, b, 90.0f, ok);
+        zassert_true(ok, "%d br/min: no estimate", (int)brpm);
+        zassert_within(e.brpm, brpm, 1.5f, "%d br/min estimated as %d.%01d", (int)brpm,
+                       (int)e.brpm, (int)(e.brpm * 10.0f) % 10);
+        zassert_equal(e.series, 0x7, "%d br/min: series mask %x", (int)brpm, e.series);
+    }
+}
+
+ZTEST(respiration, test_each_modulation)
+{
+    /* One modulation alone still drives its own series */
+    const struct {
+        bool am, bm, fm;
+        RespirationEstimator::Series s;
+        const char* name;
+    } cases[] = {
+        { false, true, false, RespirationEstimator::RIIV, "RIIV" },
+        { true, false, false, RespirationEstimator::RIAV, "RIAV" },
+        { false, false, true, RespirationEstimator::RIFV, "RIFV" },
+    };
+    for (const auto &c : cases) {
+        RespirationEstimator r;
+        Breathing b;
+        b.brpm = 12.0f;
+        b.am = c.am;
+        b.bm = c.bm;
+        b.fm = c.fm;
+        bool ok;
+        run(r, b, 90.0f, ok);
+        float brpm = 0.0f;
+        zassert_true(r.seriesRate(c.s, brpm), "%s: no rate", c.name);
+        TC_PRINT("%s alone: %d.%01d br/min\n", c.name, (int)brpm, (int)(brpm * 10.0f) % 10);
+        zassert_within(brpm, 12.0f, 1.5f, "%s: %d br/min", c.name, (int)brpm);
+    }
+}
+
+ZTEST(respiration, test_reset_forgets_breaths)
+{
+    RespirationEstimator r;
+    Breathing b;
+    bool ok;
+    run(r, b, 60.0f, ok);
+    zassert_true(ok, "no estimate");
+    r.reset();
+    RespirationEstimator::Estimate e;
+    zassert_false(r.estimate(e), "estimate after reset");
+    float brpm;
+    zassert_false(r.seriesRate(RespirationEstimator::SERIES, brpm), "out-of-range series");
+}
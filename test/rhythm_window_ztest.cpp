@@ -0,0 +1,213 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "rhythm_window.h"
+#include "bench_util.h"
+
+/* RR series: sinus rhythm around `base` with respiratory modulation and
+ * beat-to-beat jitter, or AF-like independent intervals over 400..1100 ms */
+struct RhythmSynth {
+    uint32_t seed = 4242u;
+    float base = 800.0f;
+    float t = 0.0f;
+    bool af = false;
+
+    float rand01()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 16777216.0f;
+    }
+
+    uint16_t next()
+    {
+        t += 1.0f;
+        if (af) {
+            return (uint16_t)(400.0f + 700.0f * rand01());
+        }
+        return (uint16_t)(base + 40.0f * sinf(0.4f * t) + 30.0f * (rand01() - 0.5f));
+    }
+};
+
+/* Textbook indices over the last `cap` intervals; pair[i]: rr[i] follows
+ * rr[i - 1] */
+struct Reference {
+    float nrmssd, sd1_sd2, sampen;
+    size_t pairs;
+};
+
+static Reference reference(const uint16_t* rr, const bool* pair, size_t n, size_t cap)
+{
+    const size_t first = n > cap ? n - cap : 0;
+    const size_t count = n - first;
+    Reference r{};
+    double mean = 0.0;
+    for (size_t i = first; i < n; ++i) mean += rr[i];
+    mean /= (double)count;
+
+    double sd = 0.0, ss = 0.0, sd2 = 0.0, ss2 = 0.0;
+    for (size_t i = first + 1; i < n; ++i) {
+        if (!pair[i]) continue;
+        const double d = (double)rr[i] - rr[i - 1];
+        const double s = (double)rr[i] + rr[i - 1];
+        sd += d;
+        sd2 += d * d;
+        ss += s;
+        ss2 += s * s;
+        ++r.pairs;
+    }
+    const double p = (double)r.pairs;
+    r.nrmssd = (float)(sqrt(sd2 / p) / mean);
+    r.sd1_sd2 = (float)sqrt((sd2 - sd * sd / p) / (ss2 - ss * ss / p));
+
+    /* Template matches by brute force */
+    size_t m1 = 0, m2 = 0;
+    for (size_t i = first; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (abs((int)rr[i] - (int)rr[j]) > 30) continue;
+            ++m1;
+            if (i > first && pair[i] && pair[j] && abs((int)rr[i - 1] - (int)rr[j - 1]) <= 30) {
+                ++m2;
+            }
+        }
+    }
+    const double p1 = (double)m1 / (0.5 * (double)count * (double)(count - 1));
+    const double p2 = (double)(m2 ? m2 : 1) / (0.5 * p * (p - 1.0));
+    r.sampen = (float)log(p1 / p2);
+    return r;
+}
+
+ZTEST_SUITE(rhythm_window, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(rhythm_window, test_matches_rescan)
+{
+    static uint16_t rr[2000];
+    static bool pair[2000];
+    RhythmSynth synth;
+    RhythmWindow<64> w;
+
+    for (size_t i = 0; i < 2000; ++i) {
+        /* Alternate rhythms so both ends of the indices are exercised */
+        synth.af = (i / 300) % 2 == 1;
+        rr[i] = synth.next();
+        const bool successive = (i % 41) != 0;
+        pair[i] = successive && i > 0;
+        w.add(rr[i], successive);
+
+        if (i >= 64 && i % 37 == 0) {
+            const Reference ref = reference(rr, pair, i + 1, 64);
+            RhythmWindow<64>::Metrics m;
+            zassert_true(w.metrics(m), "no metrics at %u", (unsigned)i);
+            zassert_equal(m.pairs, ref.pairs, "pairs %u vs %u at %u", m.pairs,
+                          (unsigned)ref.pairs, (unsigned)i);
+            zassert_within(m.nrmssd, ref.nrmssd, 1e-4f, "nRMSSD off at %u", (unsigned)i);
+            zassert_within(m.sd1_sd2, ref.sd1_sd2, 1e-3f, "SD1/SD2 off at %u", (unsigned)i);
+            zassert_within(m.sampen, ref.sampen, 1e-3f, "SampEn %d vs %d (x1000) at %u",
+                           (int)(1000 * m.sampen), (int)(1000 * ref.sampen), (unsigned)i);
+        }
+    }
+}
+
+ZTEST(rhythm_window, test_sinus_regular_af_irregular)
+{
+    const float bases[] = { 500.0f, 800.0f, 1200.0f };
+    for (float base : bases) {
+        RhythmSynth synth;
+        synth.base = base;
+        RhythmWindow<64> w;
+        for (int i = 0; i < 200; ++i) {
+            w.add(synth.next(), true);
+        }
+        RhythmWindow<64>::Metrics m;
+        zassert_true(w.metrics(m), "no metrics");
+        TC_PRINT("sinus %4d ms: nRMSSD %d %%, SD1/SD2 %d %%, COSEn %d/100, votes %u\n",
+                 (int)base, (int)(100 * m.nrmssd), (int)(100 * m.sd1_sd2),
+                 (int)(100 * m.cosen), m.votes);
+        zassert_false(m.irregular, "sinus at %d ms flagged", (int)base);
+        zassert_equal(m.votes, 0, "sinus at %d ms: %u votes", (int)base, m.votes);
+    }
+
+    RhythmSynth synth;
+    synth.af = true;
+    RhythmWindow<64> w;
+    for (int i = 0; i < 200; ++i) {
+        w.add(synth.next(), true);
+    }
+    RhythmWindow<64>::Metrics m;
+    zassert_true(w.metrics(m), "no metrics");
+    TC_PRINT("AF-like: nRMSSD %d %%, SD1/SD2 %d %%, COSEn %d/100, votes %u\n",
+             (int)(100 * m.nrmssd), (int)(100 * m.sd1_sd2), (int)(100 * m.cosen), m.votes);
+    zassert_true(m.irregular, "AF-like rhythm not flagged");
+    zassert_equal(m.votes, 3, "%u votes", m.votes);
+}
+
+ZTEST(rhythm_window, test_isolated_ectopics_not_flagged)
+{
+    /* A premature beat and its compensatory pause every 12 beats: nRMSSD
+     * rises, but the pattern repeats and the rest is regular */
+    RhythmSynth synth;
+    RhythmWindow<64> w;
+    for (int i = 0; i < 300; ++i) {
+        uint16_t rr = synth.next();
+        if (i % 12 == 10) rr = (uint16_t)(rr * 0.65f);
+        if (i % 12 == 11) rr = (uint16_t)(rr * 1.35f);
+        w.add(rr, true);
+    }
+    RhythmWindow<64>::Metrics m;
+    zassert_true(w.metrics(m), "no metrics");
+    TC_PRINT("ectopics: nRMSSD %d %%, SD1/SD2 %d %%, COSEn %d/100, votes %u\n",
+             (int)(100 * m.nrmssd), (int)(100 * m.sd1_sd2), (int)(100 * m.cosen), m.votes);
+    zassert_false(m.irregular, "isolated ectopics flagged");
+}
+
+ZTEST(rhythm_window, test_gaps_and_reset)
+{
+    RhythmWindow<16> w;
+    for (int i = 0; i < 40; ++i) {
+        w.add(800, false);          /* never successive: no pairs */
+    }
+    RhythmWindow<16>::Metrics m;
+    zassert_false(w.metrics(m), "metrics without pairs");
+    zassert_equal(w.size(), 16, "size %u", (unsigned)w.size());
+
+    w.add(100, true);               /* out of range: dropped, breaks the chain */
+    w.add(800, true);
+    zassert_false(w.metrics(m), "pair across a dropped interval");
+
+    w.reset();
+    zassert_equal(w.size(), 0, "reset kept intervals");
+}
+
+ZTEST(rhythm_window, test_bench_cycles_per_interval)
+{
+    static uint16_t rr[1000];
+    RhythmSynth synth;
+    synth.af = true;
+    for (auto &v : rr) v = synth.next();
+
+    RhythmWindow<64> w64;
+    RhythmWindow<128> w128;
+    for (int i = 0; i < 128; ++i) {
+        w64.add(rr[i], true);
+        w128.add(rr[i], true);
+    }
+    volatile bool sink = false;
+    uint64_t c64 = bench_cycles([&] {
+        for (size_t i = 0; i < 1000; ++i) {
+            w64.add(rr[i], true);
+            RhythmWindow<64>::Metrics m;
+            sink = w64.metrics(m) && m.irregular;
+        }
+    });
+    uint64_t c128 = bench_cycles([&] {
+        for (size_t i = 0; i < 1000; ++i) {
+            w128.add(rr[i], true);
+            RhythmWindow<128>::Metrics m;
+            sink = w128.metrics(m) && m.irregular;
+        }
+    });
+    (void)sink;
+    TC_PRINT("per interval, add + metrics:\n");
+    BENCH_PRINT("  64 intervals", c64, 1000);
+    BENCH_PRINT("  128 intervals", c128, 1000);
+}
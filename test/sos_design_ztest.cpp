@@ -0,0 +1,119 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "hr_filter.h"
+#include "sos_design.h"
+
+static constexpr double PI = 3.14159265358979323846;
+
+/* scipy butter() output for fs = 100 Hz, as previously hard-coded */
+static const float LEGACY_SOS_100HZ[3][5] = {
+    { 0.967694809f, -1.935389618f,  0.967694809f, -1.954001962f,  0.954619251f },
+    { 1.0f,         -2.0f,          1.0f,         -1.980323859f,  0.980949464f },
+    { 0.036574836f,  0.073149672f,  0.036574836f, -1.390895281f,  0.537194625f }
+};
+
+/* |H(e^jw)| of one section */
+static double section_mag(double b0, double b1, double b2, double a1, double a2,
+                          double f, double fs)
+{
+    double w = 2.0 * PI * f / fs;
+    double c1 = cos(w), s1 = sin(w), c2 = cos(2.0 * w), s2 = sin(2.0 * w);
+    double nr = b0 + b1 * c1 + b2 * c2, ni = -(b1 * s1 + b2 * s2);
+    double dr = 1.0 + a1 * c1 + a2 * c2, di = -(a1 * s1 + a2 * s2);
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+template <size_t N>
+static double cascade_mag(const BiquadCascadeDF2T<N> &c, double f, double fs)
+{
+    double m = 1.0;
+    for (const auto &s : c.sec) m *= section_mag(s.b0, s.b1, s.b2, s.a1, s.a2, f, fs);
+    return m;
+}
+
+static double legacy_mag(double f)
+{
+    double m = 1.0;
+    for (const auto &r : LEGACY_SOS_100HZ) m *= section_mag(r[0], r[1], r[2], r[3], r[4], f, 100.0);
+    return m;
+}
+
+ZTEST_SUITE(sos_design, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(sos_design, test_matches_legacy_100hz_table)
+{
+    constexpr BiquadCascadeDF2T<3> c = sos_hr_bandpass(100.0);
+
+    /* Poles are identical; gain is spread across sections instead of all in the first */
+    for (size_t i = 0; i < 3; ++i) {
+        zassert_within(c.sec[i].a1, LEGACY_SOS_100HZ[i][3], 1e-6f, "a1[%u]", (unsigned)i);
+        zassert_within(c.sec[i].a2, LEGACY_SOS_100HZ[i][4], 1e-6f, "a2[%u]", (unsigned)i);
+    }
+
+    const double freqs[] = { 0.1, 0.4, 1.0, 2.0, 3.5, 7.0, 10.0, 25.0 };
+    for (double f : freqs) {
+        double got = cascade_mag(c, f, 100.0);
+        double want = legacy_mag(f);
+        zassert_true(fabs(got - want) <= 1e-4 * (1.0 + want),
+                     "|H(%.1f Hz)| = %f, legacy %f", f, got, want);
+    }
+}
+
+ZTEST(sos_design, test_band_edges_at_every_rate)
+{
+    const uint32_t rates[] = { 25, 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+    for (uint32_t fs : rates) {
+        BiquadCascadeDF2T<3> c;
+        zassert_true(hr_filter_load(c, fs), "no table for %u Hz", fs);
+        zassert_true(sos_is_stable(c), "unstable at %u Hz", fs);
+
+        double dc = cascade_mag(c, 0.0, fs);
+        double hp_edge = cascade_mag(c, HR_BAND_HP_HZ, fs);
+        double pass = cascade_mag(c, 1.0, fs);
+        double stop = cascade_mag(c, 10.0, fs);
+
+        zassert_true(dc < 1e-3, "%u Hz: DC gain %f", fs, dc);
+        zassert_true(hp_edge > 0.65 && hp_edge < 0.75, "%u Hz: 0.4 Hz gain %f", fs, hp_edge);
+        zassert_true(pass > 0.9 && pass < 1.05, "%u Hz: 1 Hz gain %f", fs, pass);
+        zassert_true(stop < 0.5 * pass, "%u Hz: 10 Hz gain %f", fs, stop);
+    }
+}
+
+ZTEST(sos_design, test_unsupported_rate_rejected)
+{
+    BiquadCascadeDF2T<3> c;
+    zassert_false(hr_filter_load(c, 123), "loaded a table for 123 Hz");
+    zassert_false(hr_filter_set_sample_rate(123), "accepted 123 Hz");
+}
+
+ZTEST(sos_design, test_rate_switch_without_glitch)
+{
+    const float dc = 1000.0f;
+    const float ac = 10.0f;
+    const float f_hr = 1.2f;
+    static float buf[6000];
+
+    /* Settle at 100 Hz for 60 s */
+    hr_filter_init();
+    for (size_t i = 0; i < 6000; ++i) {
+        buf[i] = dc + ac * sinf(2.0f * (float)PI * f_hr * (float)i / 100.0f);
+    }
+    hr_filter_process(buf, buf, 6000);
+
+    /* Continue the same waveform at 200 Hz */
+    zassert_true(hr_filter_set_sample_rate(200), "200 Hz not supported");
+    const float t0 = 60.0f;
+    for (size_t i = 0; i < 1000; ++i) {
+        buf[i] = dc + ac * sinf(2.0f * (float)PI * f_hr * (t0 + (float)i / 200.0f));
+    }
+    hr_filter_process(buf, buf, 1000);
+
+    float peak = 0.0f;
+    for (size_t i = 0; i < 1000; ++i) {
+        if (fabsf(buf[i]) > peak) peak = fabsf(buf[i]);
+    }
+    /* A plain coefficient swap rings on the DC offset (order of dc) */
+    zassert_true(peak < 2.0f * ac, "switch transient %f exceeds %f", (double)peak,
+                 (double)(2.0f * ac));
+}
@@ -0,0 +1,110 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "spectral_hr.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr size_t BLOCK = 10;
+
+static void run(PpgSynth& ppg, HrFilter& f, SpectralHr& s, float seconds)
+{
+    float buf[BLOCK];
+    size_t total = (size_t)(seconds * ppg.fs);
+    for (size_t off = 0; off < total; off += BLOCK) {
+        ppg.fill(buf, BLOCK);
+        f.process(buf, buf, BLOCK);
+        s.process(buf, BLOCK);
+    }
+}
+
+static void start(PpgSynth& ppg, HrFilter& f, SpectralHr& s, uint32_t fs)
+{
+    ppg.fs = (float)fs;
+    zassert_true(f.init(fs, ppg.dc), "no band-pass for %u Hz", fs);
+    zassert_true(s.init(fs), "spectral init failed at %u Hz", fs);
+}
+
+ZTEST_SUITE(spectral_hr, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(spectral_hr, test_window_and_bins)
+{
+    SpectralHr s;
+    zassert_true(s.init(50), "50 Hz rejected");
+    zassert_equal(s.windowLength(), 400u, "8 s at 50 Hz");
+    zassert_true(s.binCount() <= SpectralHr::BINS_MAX, "too many bins");
+    zassert_true(s.init(100), "100 Hz rejected");
+    zassert_equal(s.windowLength(), SpectralHr::WINDOW_MAX, "window not capped");
+    zassert_false(s.init(5), "5 Hz cannot hold the cardiac band");
+
+    /* No estimate before the window is full */
+    s.init(50);
+    float x[100] = { 0 };
+    for (int i = 0; i < 3; ++i) s.process(x, 100);
+    SpectralHr::Estimate e;
+    zassert_false(s.estimate(e), "estimate from a partial window");
+}
+
+ZTEST(spectral_hr, test_bpm_40_to_200)
+{
+    const float rates[] = { 40, 60, 75, 90, 120, 150, 180, 200 };
+    const uint32_t fs_list[] = { 25, 50, 100 };
+    for (uint32_t fs : fs_list) {
+        for (float bpm : rates) {
+            PpgSynth ppg;
+            ppg.bpm = bpm;
+            HrFilter f;
+            SpectralHr s;
+            start(ppg, f, s, fs);
+            run(ppg, f, s, 15.0f);
+
+            SpectralHr::Estimate e;
+            zassert_true(s.estimate(e), "%u Hz, %d BPM: no estimate", fs, (int)bpm);
+            zassert_within(e.bpm, bpm, 2.0f, "%u Hz: %d BPM estimated as %d",
+                           fs, (int)bpm, (int)e.bpm);
+            zassert_true(e.confidence > 0.6f, "%u Hz, %d BPM: confidence %d%%",
+                         fs, (int)bpm, (int)(e.confidence * 100.0f));
+        }
+    }
+}
+
+ZTEST(spectral_hr, test_distorted_peaks)
+{
+    /* Motion spikes every 0.7 s and heavy noise break the pulse shape but
+     * not its fundamental */
+    PpgSynth ppg;
+    ppg.bpm = 84.0f;
+    ppg.noise = 400.0f;
+    HrFilter f;
+    SpectralHr s;
+    start(ppg, f, s, 50);
+
+    float buf[BLOCK];
+    for (size_t off = 0; off < 50 * 20; off += BLOCK) {
+        ppg.fill(buf, BLOCK);
+        for (size_t i = 0; i < BLOCK; ++i) {
+            if ((off + i) % 35 == 0) buf[i] += 3000.0f;
+        }
+        f.process(buf, buf, BLOCK);
+        s.process(buf, BLOCK);
+    }
+    SpectralHr::Estimate e;
+    zassert_true(s.estimate(e), "no estimate");
+    zassert_within(e.bpm, 84.0f, 3.0f, "estimated %d BPM", (int)e.bpm);
+}
+
+ZTEST(spectral_hr, test_noise_has_low_confidence)
+{
+    PpgSynth ppg;
+    ppg.ac = 0.0f;
+    ppg.noise = 1000.0f;
+    HrFilter f;
+    SpectralHr s;
+    start(ppg, f, s, 50);
+    run(ppg, f, s, 20.0f);
+
+    SpectralHr::Estimate e;
+    zassert_true(s.estimate(e), "no estimate");
+    zassert_true(e.confidence < 0.4f, "white noise confidence %d%%",
+                 (int)(e.confidence * 100.0f));
+}
@@ -0,0 +1,110 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "spo2_estimator.h"
+#include "hr_filter.h"
+#include "ppg_synth.h"
+
+static constexpr size_t BLOCK = 10;
+
+/* Red and IR with the same pulse, perfusion index PI_IR on IR and
+ * R * PI_IR on red, run through the pipeline the HR thread uses */
+static constexpr float PI_IR = 0.01f;
+
+struct DualPpg {
+    PpgSynth red, ir;
+    HrFilter fr, fi;
+    Spo2Estimator s;
+
+    DualPpg(float bpm, float r, float noise)
+    {
+        ir.dc = 120000.0f;
+        ir.ac = PI_IR * ir.dc;
+        red.dc = 70000.0f;
+        red.ac = r * PI_IR * red.dc;
+        red.bpm = ir.bpm = bpm;
+        red.noise = ir.noise = noise;
+        red.seed = 777u;
+        fr.init(50, red.dc);
+        fi.init(50, ir.dc);
+        s.init(50);
+    }
+
+    void run(float seconds)
+    {
+        float br[BLOCK], bi[BLOCK];
+        for (size_t off = 0; off < (size_t)(seconds * 50.0f); off += BLOCK) {
+            red.fill(br, BLOCK);
+            ir.fill(bi, BLOCK);
+            s.updateDc(br, bi, BLOCK);
+            fr.process(br, br, BLOCK);
+            fi.process(bi, bi, BLOCK);
+            s.updateAc(br, bi, BLOCK);
+        }
+    }
+};
+
+ZTEST_SUITE(spo2_estimator, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(spo2_estimator, test_calibration_curve)
+{
+    zassert_within(Spo2Estimator::spo2FromRatio(0.4f), 99.8f, 0.1f, "R 0.4");
+    zassert_within(Spo2Estimator::spo2FromRatio(0.7f), 94.0f, 0.1f, "R 0.7");
+    zassert_within(Spo2Estimator::spo2FromRatio(1.0f), 80.1f, 0.1f, "R 1.0");
+    zassert_equal(Spo2Estimator::spo2FromRatio(1.5f), Spo2Estimator::SPO2_MIN, "not clamped low");
+    zassert_true(Spo2Estimator::spo2FromRatio(0.3f) <= 100.0f, "above 100 %%");
+}
+
+ZTEST(spo2_estimator, test_known_ratio)
+{
+    const float ratios[] = { 0.5f, 0.7f, 1.0f };
+    const float rates[] = { 45.0f, 75.0f, 150.0f };
+    for (float r : ratios) {
+        for (float bpm : rates) {
+            DualPpg p(bpm, r, 0.0f);
+            Spo2Estimator::Estimate e;
+            p.run(2.0f);
+            zassert_false(p.s.estimate(e), "estimate before warm-up");
+            p.run(10.0f);
+            zassert_true(p.s.estimate(e), "R %d%%, %d BPM: no estimate",
+                         (int)(r * 100.0f), (int)bpm);
+            zassert_within(e.ratio, r, 0.02f * r, "R %d%%, %d BPM: measured %d%%",
+                           (int)(r * 100.0f), (int)bpm, (int)(e.ratio * 100.0f));
+            zassert_within(e.spo2, Spo2Estimator::spo2FromRatio(r), 1.0f,
+                           "R %d%%: SpO2 %d", (int)(r * 100.0f), (int)e.spo2);
+        }
+    }
+}
+
+ZTEST(spo2_estimator, test_noisy_channels)
+{
+    /* Independent noise at 5 % of the IR pulse on both channels (peak-to-peak
+     * picks up noise extremes, which pulls R towards 1) */
+    DualPpg p(80.0f, 0.6f, 0.05f * PI_IR * 120000.0f);
+    p.run(20.0f);
+    Spo2Estimator::Estimate e;
+    zassert_true(p.s.estimate(e), "no estimate");
+    zassert_within(e.ratio, 0.6f, 0.06f, "measured R %d%%", (int)(e.ratio * 100.0f));
+    TC_PRINT("noisy: R %d%%, SpO2 %d %%\n", (int)(e.ratio * 100.0f), (int)e.spo2);
+}
+
+ZTEST(spo2_estimator, test_follows_desaturation)
+{
+    DualPpg p(70.0f, 0.5f, 0.0f);
+    p.run(10.0f);
+    p.red.ac = 0.9f * PI_IR * p.red.dc;
+    p.run(10.0f);
+    Spo2Estimator::Estimate e;
+    zassert_true(p.s.estimate(e), "no estimate");
+    zassert_within(e.spo2, Spo2Estimator::spo2FromRatio(0.9f), 1.0f,
+                   "SpO2 %d after the step", (int)e.spo2);
+}
+
+ZTEST(spo2_estimator, test_no_pulse)
+{
+    DualPpg p(70.0f, 0.6f, 2.0f);
+    p.red.ac = p.ir.ac = 0.0f;
+    p.run(10.0f);
+    Spo2Estimator::Estimate e;
+    zassert_false(p.s.estimate(e), "estimate without a pulse");
+}
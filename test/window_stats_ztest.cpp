@@ -0,0 +1,124 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+
+#include "window_stats.h"
+
+/* Deterministic test stream: a wander plus uniform noise */
+struct Stream {
+    uint32_t seed = 2024u;
+    float t = 0.0f;
+    float dc = 0.0f;
+
+    float next()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        t += 1.0f;
+        return dc + 50.0f * sinf(0.013f * t) + 10.0f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+    }
+};
+
+/* Rescan of the last len values pushed */
+static void brute(const float* hist, size_t count, size_t len,
+                  float& mean, float& var, float& lo, float& hi)
+{
+    const size_t n = count < len ? count : len;
+    double s = 0.0;
+    lo = hi = hist[count - 1];
+    for (size_t i = count - n; i < count; ++i) {
+        s += hist[i];
+        if (hist[i] < lo) lo = hist[i];
+        if (hist[i] > hi) hi = hist[i];
+    }
+    mean = (float)(s / (double)n);
+    double q = 0.0;
+    for (size_t i = count - n; i < count; ++i) q += (hist[i] - mean) * (hist[i] - mean);
+    var = n > 1 ? (float)(q / (double)(n - 1)) : 0.0f;
+}
+
+ZTEST_SUITE(window_stats, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(window_stats, test_windows_share_one_ring)
+{
+    static float hist[5000];
+    SampleRing<128> ring;
+    WindowStats<128> w_short(ring, 10);
+    WindowStats<128> w_mid(ring, 50);
+    WindowStats<128> w_long(ring, 100);
+    Stream src;
+
+    size_t count = 0;
+    size_t block = 1;
+    while (count + block <= 5000) {
+        for (size_t i = 0; i < block; ++i) {
+            hist[count] = src.next();
+            ring.push(hist[count++]);
+        }
+        block = block % 23 + 1;   /* 1..23 samples between updates */
+        w_short.update();
+        w_mid.update();
+        w_long.update();
+
+        WindowStats<128>* w[] = { &w_short, &w_mid, &w_long };
+        for (auto *p : w) {
+            float mean, var, lo, hi;
+            brute(hist, count, p->windowLength(), mean, var, lo, hi);
+            zassert_equal(p->size(), count < p->windowLength() ? count : p->windowLength(),
+                          "size %u at %u", (unsigned)p->size(), (unsigned)count);
+            zassert_within(p->mean(), mean, 1e-2f, "len %u mean off at %u",
+                           (unsigned)p->windowLength(), (unsigned)count);
+            zassert_within(p->variance(), var, 1e-3f * var + 1e-2f, "len %u variance off at %u",
+                           (unsigned)p->windowLength(), (unsigned)count);
+            zassert_equal(p->min(), lo, "len %u min off at %u",
+                          (unsigned)p->windowLength(), (unsigned)count);
+            zassert_equal(p->max(), hi, "len %u max off at %u",
+                          (unsigned)p->windowLength(), (unsigned)count);
+        }
+    }
+}
+
+ZTEST(window_stats, test_no_drift_on_large_offset)
+{
+    /* PPG-like counts: 1e5 DC, so float sums lose the small variance
+     * unless the window resynchronizes */
+    SampleRing<128> ring;
+    WindowMoments<128> w(ring, 64);
+    Stream src;
+    src.dc = 100000.0f;
+    float last[64];
+    for (uint32_t i = 0; i < 200000; ++i) {
+        const float v = src.next();
+        last[i % 64] = v;
+        ring.push(v);
+        w.update();
+    }
+    float mean, var, lo, hi;
+    float ordered[64];
+    for (size_t i = 0; i < 64; ++i) ordered[i] = last[(200000 + i) % 64];
+    brute(ordered, 64, 64, mean, var, lo, hi);
+    zassert_within(w.mean(), mean, 0.05f, "mean drifted");
+    zassert_within(w.variance(), var, 0.02f * var, "variance %d vs %d",
+                   (int)w.variance(), (int)var);
+}
+
+ZTEST(window_stats, test_restart_after_falling_behind)
+{
+    SampleRing<32> ring;
+    WindowExtrema<32> w(ring, 8);
+    for (int i = 0; i < 8; ++i) ring.push(1000.0f);
+    w.update();
+    zassert_equal(w.max(), 1000.0f, "max");
+
+    /* More than the ring can hold for this window between updates: only
+     * the newest 8 count */
+    for (int i = 0; i < 10; ++i) ring.push(2000.0f);
+    for (int i = 0; i < 20; ++i) ring.push((float)i);
+    w.update();
+    zassert_equal(w.min(), 12.0f, "min %d", (int)w.min());
+    zassert_equal(w.max(), 19.0f, "max %d", (int)w.max());
+
+    ring.clear();
+    ring.push(-5.0f);
+    w.update();
+    zassert_equal(w.min(), -5.0f, "ring clear not seen");
+    zassert_equal(w.max(), -5.0f, "ring clear not seen");
+}